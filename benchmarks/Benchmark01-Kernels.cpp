@@ -0,0 +1,240 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#include <EasyFactorGraph/categoric/GroupRange.h>
+#include <EasyFactorGraph/factor/Factor.h>
+#include <EasyFactorGraph/factor/FactorExponential.h>
+#include <EasyFactorGraph/structure/GibbsSampler.h>
+#include <EasyFactorGraph/structure/SpecialFactors.h>
+#include <EasyFactorGraph/structure/bases/PoolAware.h>
+
+#include <Benchmark.h>
+
+using namespace EFG;
+using namespace EFG::categoric;
+using namespace EFG::factor;
+using namespace EFG::strct;
+
+namespace {
+// the parameters of each benchmark are in the form {domain size, number of
+// variables}
+const std::vector<std::vector<std::size_t>> BINARY_SIZES = {
+    {2, 2}, {10, 2}, {50, 2}, {200, 2}};
+const std::vector<std::vector<std::size_t>> MULTI_SIZES = {
+    {2, 3}, {5, 3}, {10, 3}, {2, 5}, {5, 5}};
+
+VariablesSoup make_vars(std::size_t size, std::size_t number,
+                        const std::string &prefix = "V") {
+  VariablesSoup result;
+  for (std::size_t k = 0; k < number; ++k) {
+    result.push_back(make_variable(size, prefix + std::to_string(k)));
+  }
+  return result;
+}
+
+std::vector<std::vector<std::size_t>>
+all_combinations(const VariablesSoup &vars) {
+  std::vector<std::vector<std::size_t>> result;
+  GroupRange range{Group{vars}};
+  for_each_combination(range,
+                       [&result](const auto &comb) { result.push_back(comb); });
+  return result;
+}
+
+Factor make_random_factor(const VariablesSoup &vars) {
+  Factor result{Group{vars}};
+  std::size_t counter = 0;
+  GroupRange range{Group{vars}};
+  for_each_combination(range, [&](const auto &comb) {
+    result.set(comb, static_cast<float>(1 + (counter++ % 7)));
+  });
+  return result;
+}
+
+// few combinations: the function remains sparse
+void function_set_sparse(bench::State &state) {
+  auto vars = make_vars(state.range(0), state.range(1));
+  Function subject{Group{vars}};
+  const std::size_t combinations =
+      std::max<std::size_t>(1, subject.getInfo().critical_size / 2);
+  auto all = all_combinations(vars);
+  all.resize(std::min(all.size(), combinations));
+  for (auto _ : state) {
+    subject.clear();
+    for (const auto &comb : all) {
+      subject.set(comb, 1.f);
+    }
+  }
+  state.setItemsProcessed(state.iterations() * all.size());
+}
+
+void function_set_dense(bench::State &state) {
+  auto vars = make_vars(state.range(0), state.range(1));
+  Function subject{Group{vars}};
+  const auto all = all_combinations(vars);
+  for (const auto &comb : all) {
+    subject.set(comb, 1.f);
+  }
+  for (auto _ : state) {
+    for (const auto &comb : all) {
+      subject.set(comb, 2.f);
+    }
+  }
+  state.setItemsProcessed(state.iterations() * all.size());
+}
+
+template <bool Dense> void function_find_image(bench::State &state) {
+  auto vars = make_vars(state.range(0), state.range(1));
+  Function subject{Group{vars}};
+  auto all = all_combinations(vars);
+  if constexpr (!Dense) {
+    all.resize(std::min(
+        all.size(),
+        std::max<std::size_t>(1, subject.getInfo().critical_size / 2)));
+  }
+  for (const auto &comb : all) {
+    subject.set(comb, 1.f);
+  }
+  for (auto _ : state) {
+    float sum = 0;
+    for (const auto &comb : all) {
+      sum += subject.findImage(comb);
+    }
+    bench::do_not_optimize(sum);
+  }
+  state.setItemsProcessed(state.iterations() * all.size());
+}
+
+// a binary factor looked up from combinations of the whole (bigger) group
+void image_finder(bench::State &state) {
+  auto vars = make_vars(state.range(0), state.range(1));
+  const Factor subject =
+      make_random_factor(VariablesSoup{vars.back(), vars.front()});
+  const auto finder = subject.makeFinder(vars);
+  const auto all = all_combinations(vars);
+  for (auto _ : state) {
+    float sum = 0;
+    for (const auto &comb : all) {
+      sum += finder.findImage(comb);
+    }
+    bench::do_not_optimize(sum);
+  }
+  state.setItemsProcessed(state.iterations() * all.size());
+}
+
+void factor_merge(bench::State &state) {
+  // a chain of binary factors sharing one variable with the next one
+  auto vars = make_vars(state.range(0), state.range(1));
+  std::vector<Factor> factors;
+  for (std::size_t k = 1; k < vars.size(); ++k) {
+    factors.emplace_back(make_random_factor(VariablesSoup{vars[k - 1], vars[k]}));
+  }
+  std::vector<const Immutable *> to_merge;
+  for (const auto &factor : factors) {
+    to_merge.push_back(&factor);
+  }
+  for (auto _ : state) {
+    Factor merged{to_merge};
+    bench::do_not_optimize(merged);
+  }
+  state.setItemsProcessed(state.iterations() *
+                          Group{vars}.size());
+}
+
+void factor_clone_permuted(bench::State &state) {
+  auto vars = make_vars(state.range(0), state.range(1));
+  const Factor subject = make_random_factor(vars);
+  VariablesSoup reversed{vars.rbegin(), vars.rend()};
+  const Group new_order{reversed};
+  for (auto _ : state) {
+    auto permuted = subject.cloneWithPermutedGroup(new_order);
+    bench::do_not_optimize(permuted);
+  }
+  state.setItemsProcessed(state.iterations() *
+                          subject.function().getInfo().totCombinations);
+}
+
+template <typename MessageT> void message(bench::State &state) {
+  auto vars = make_vars(state.range(0), 2);
+  const FactorExponential binary{make_random_factor(vars), 0.5f};
+  const MergedUnaries sender{vars.front()};
+  for (auto _ : state) {
+    MessageT result{sender, binary};
+    bench::do_not_optimize(result);
+  }
+  state.setItemsProcessed(state.iterations() *
+                          binary.function().getInfo().totCombinations);
+}
+
+void group_range(bench::State &state) {
+  auto vars = make_vars(state.range(0), state.range(1));
+  const Group group{vars};
+  for (auto _ : state) {
+    std::size_t sum = 0;
+    GroupRange range{group};
+    for_each_combination(range,
+                         [&sum](const auto &comb) { sum += comb.back(); });
+    bench::do_not_optimize(sum);
+  }
+  state.setItemsProcessed(state.iterations() * group.size());
+}
+
+// parameters are {threads, tasks}
+void pool_parallel_for(bench::State &state) {
+  Pool pool{state.range(0)};
+  Tasks tasks;
+  std::vector<std::size_t> counters;
+  counters.resize(state.range(0));
+  for (std::size_t k = 0; k < state.range(1); ++k) {
+    tasks.emplace_back(
+        [&counters](const std::size_t th_id) { ++counters[th_id]; });
+  }
+  for (auto _ : state) {
+    pool.parallelFor(tasks);
+  }
+  bench::do_not_optimize(counters);
+  state.setItemsProcessed(state.iterations() * tasks.size());
+}
+
+// parameters are {distribution size}
+void sample_from_discrete(bench::State &state) {
+  std::vector<float> distribution;
+  distribution.resize(state.range(0), 1.f / static_cast<float>(state.range(0)));
+  UniformSampler sampler;
+  sampler.resetSeed(0);
+  const std::size_t samples = 1000;
+  for (auto _ : state) {
+    std::size_t sum = 0;
+    for (std::size_t k = 0; k < samples; ++k) {
+      sum += sampler.sampleFromDiscrete(distribution);
+    }
+    bench::do_not_optimize(sum);
+  }
+  state.setItemsProcessed(state.iterations() * samples);
+}
+} // namespace
+
+int main(int argc, const char **argv) {
+  bench::add("Function::set/sparse", function_set_sparse, BINARY_SIZES);
+  bench::add("Function::set/dense", function_set_dense, BINARY_SIZES);
+  bench::add("Function::findImage/sparse", function_find_image<false>,
+             BINARY_SIZES);
+  bench::add("Function::findImage/dense", function_find_image<true>,
+             BINARY_SIZES);
+  bench::add("ImageFinder::findImage", image_finder, MULTI_SIZES);
+  bench::add("Factor::merge", factor_merge, MULTI_SIZES);
+  bench::add("Factor::cloneWithPermutedGroup", factor_clone_permuted,
+             MULTI_SIZES);
+  bench::add("MessageSUM", message<MessageSUM>, BINARY_SIZES);
+  bench::add("MessageMAP", message<MessageMAP>, BINARY_SIZES);
+  bench::add("GroupRange", group_range, MULTI_SIZES);
+  bench::add("Pool::parallelFor", pool_parallel_for,
+             {{1, 16}, {2, 16}, {4, 16}, {4, 256}});
+  bench::add("UniformSampler::sampleFromDiscrete", sample_from_discrete,
+             {{2}, {10}, {100}});
+  return bench::run(argc, argv);
+}
@@ -0,0 +1,334 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#include <EasyFactorGraph/Error.h>
+#include <EasyFactorGraph/trainable/TrainSet.h>
+
+#include <Benchmark.h>
+#include <Graphs.h>
+
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+
+using namespace EFG;
+using namespace EFG::bench;
+
+// Besides the --benchmark_ options (see Benchmark.h), the following ones can
+// be passed to specify the configurations to measure:
+// --families=<comma separated list among chain,grid,tree,scale_free>
+// --sizes=<comma separated list of (approximated) numbers of variables>
+// --domains=<comma separated list of variables domain sizes>
+// --threads=<comma separated list of threads numbers>
+// --samples=<number of samples to draw by makeSamples and to use as training
+// set when computing the gradient>
+//
+// The name of each run is in the form family/operation/size/domain[/threads].
+// For the operations that can exploit many threads, the speedup and the
+// efficiency w.r.t. the single thread run are also reported.
+
+namespace {
+struct Configuration {
+  std::vector<GraphFamily> families = {GraphFamily::CHAIN, GraphFamily::GRID,
+                                       GraphFamily::TREE,
+                                       GraphFamily::SCALE_FREE};
+  std::vector<std::size_t> sizes = {100, 1000};
+  std::vector<std::size_t> domains = {2, 5};
+  std::vector<std::size_t> threads;
+  std::size_t samples = 100;
+};
+
+std::vector<std::string> split(const std::string &subject, char separator) {
+  std::vector<std::string> result;
+  std::istringstream stream{subject};
+  std::string token;
+  while (std::getline(stream, token, separator)) {
+    result.push_back(token);
+  }
+  return result;
+}
+
+std::vector<std::size_t> parse_numbers(const std::string &subject) {
+  std::vector<std::size_t> result;
+  for (const auto &token : split(subject, ',')) {
+    result.push_back(static_cast<std::size_t>(std::stoul(token)));
+  }
+  if (result.empty()) {
+    throw Error::make(subject, " is not a valid list of numbers");
+  }
+  return result;
+}
+
+Configuration parse_configuration(int argc, const char **argv) {
+  Configuration result;
+  auto extract = [](const std::string &arg,
+                    const std::string &prefix) -> const char * {
+    if (arg.rfind(prefix, 0) == 0) {
+      return arg.c_str() + prefix.size();
+    }
+    return nullptr;
+  };
+  for (int k = 1; k < argc; ++k) {
+    const std::string arg = argv[k];
+    if (const char *val = extract(arg, "--families="); val) {
+      result.families.clear();
+      for (const auto &name : split(val, ',')) {
+        result.families.push_back(family_from_string(name));
+      }
+    } else if (const char *val = extract(arg, "--sizes="); val) {
+      result.sizes = parse_numbers(val);
+    } else if (const char *val = extract(arg, "--domains="); val) {
+      result.domains = parse_numbers(val);
+    } else if (const char *val = extract(arg, "--threads="); val) {
+      result.threads = parse_numbers(val);
+    } else if (const char *val = extract(arg, "--samples="); val) {
+      result.samples = static_cast<std::size_t>(std::stoul(val));
+    } else if (arg.rfind("--benchmark_", 0) != 0) {
+      throw Error::make(arg, " is an unknown option");
+    }
+  }
+  if (result.threads.empty()) {
+    // 1, 2, 4, ... up to the available cores
+    const std::size_t cores =
+        std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    for (std::size_t th = 1; th < cores; th *= 2) {
+      result.threads.push_back(th);
+    }
+    result.threads.push_back(cores);
+  }
+  return result;
+}
+
+GraphDescription make_description(const State &state, GraphFamily family) {
+  return make_graph_description(family, state.range(0), state.range(1));
+}
+
+void add_sizes_counters(State &state, const GraphDescription &description) {
+  state.setCounter("variables",
+                   static_cast<double>(description.variables.size()));
+  state.setCounter("edges", static_cast<double>(description.edges.size()));
+}
+
+categoric::VariablePtr first_hidden(const GraphDescription &description) {
+  const std::set<std::size_t> observed{description.observed.begin(),
+                                       description.observed.end()};
+  for (std::size_t k = 0; k < description.variables.size(); ++k) {
+    if (observed.find(k) == observed.end()) {
+      return description.variables[k];
+    }
+  }
+  throw Error{"the graph has no hidden variables"};
+}
+
+void build(State &state, GraphFamily family) {
+  const auto description = make_description(state, family);
+  for (auto _ : state) {
+    auto model = make_model(description);
+    state.pauseTiming();
+    model.reset();
+    state.resumeTiming();
+  }
+  state.setItemsProcessed(state.iterations() * description.edges.size());
+  add_sizes_counters(state, description);
+}
+
+void evidence(State &state, GraphFamily family) {
+  const auto description = make_description(state, family);
+  auto model = make_model(description);
+  for (auto _ : state) {
+    set_evidences(*model, description);
+    state.pauseTiming();
+    model->removeAllEvidences();
+    state.resumeTiming();
+  }
+  state.setItemsProcessed(state.iterations() * description.observed.size());
+  add_sizes_counters(state, description);
+}
+
+// Executes the passed query, after having changed the value of an evidence in
+// order to invalidate the previously computed belief.
+template <typename Query>
+void query(State &state, GraphFamily family, const Query &subject) {
+  const auto description = make_description(state, family);
+  auto model = make_model(description);
+  set_evidences(*model, description);
+  const auto &toggled = description.variables[description.observed.front()];
+  const auto hidden = first_hidden(description);
+  const std::size_t threads = state.range(2);
+  std::size_t value = 0;
+  for (auto _ : state) {
+    state.pauseTiming();
+    value = (value + 1) % toggled->size();
+    model->setEvidence(toggled, value);
+    state.resumeTiming();
+    subject(*model, hidden, threads);
+  }
+  state.setItemsProcessed(state.iterations() * description.variables.size());
+  add_sizes_counters(state, description);
+}
+
+void samples(State &state, GraphFamily family, std::size_t samples_number) {
+  const auto description = make_description(state, family);
+  auto model = make_model(description);
+  set_evidences(*model, description);
+  const std::size_t threads = state.range(2);
+  for (auto _ : state) {
+    auto result = model->makeSamples(
+        strct::GibbsSampler::SamplesGenerationContext{samples_number,
+                                                      std::nullopt, 0,
+                                                      std::nullopt},
+        threads);
+    do_not_optimize(result);
+  }
+  state.setItemsProcessed(state.iterations() * samples_number);
+  add_sizes_counters(state, description);
+}
+
+void gradient(State &state, GraphFamily family, std::size_t samples_number) {
+  const auto description = make_description(state, family);
+  auto model = make_model(description);
+  const train::TrainSet train_set{model->makeSamples(
+      strct::GibbsSampler::SamplesGenerationContext{
+          samples_number, std::nullopt, 0, std::nullopt},
+      1)};
+  const auto train_set_it = train_set.makeIterator();
+  const std::size_t threads = state.range(2);
+  for (auto _ : state) {
+    auto result = model->getWeightsGradient(train_set_it, threads);
+    do_not_optimize(result);
+  }
+  state.setItemsProcessed(state.iterations() * samples_number);
+  add_sizes_counters(state, description);
+}
+
+const std::string THREADS_OPERATIONS[] = {"SUM", "MAP", "hidden_set_MAP",
+                                          "samples", "gradient"};
+
+void register_all(const Configuration &config) {
+  for (auto family : config.families) {
+    const std::string prefix = to_string(family) + "/";
+    std::vector<std::vector<std::size_t>> ranges;
+    std::vector<std::vector<std::size_t>> ranges_threads;
+    for (auto size : config.sizes) {
+      for (auto domain : config.domains) {
+        ranges.push_back({size, domain});
+        for (auto threads : config.threads) {
+          ranges_threads.push_back({size, domain, threads});
+        }
+      }
+    }
+    add(
+        prefix + "build", [family](State &state) { build(state, family); },
+        ranges);
+    add(
+        prefix + "evidence",
+        [family](State &state) { evidence(state, family); }, ranges);
+    add(
+        prefix + "SUM",
+        [family](State &state) {
+          query(state, family,
+                [](model::RandomField &model,
+                   const categoric::VariablePtr &hidden, std::size_t threads) {
+                  auto result = model.getMarginalDistribution(hidden, threads);
+                  do_not_optimize(result);
+                });
+        },
+        ranges_threads);
+    add(
+        prefix + "MAP",
+        [family](State &state) {
+          query(state, family,
+                [](model::RandomField &model,
+                   const categoric::VariablePtr &hidden, std::size_t threads) {
+                  auto result = model.getMAP(hidden, threads);
+                  do_not_optimize(result);
+                });
+        },
+        ranges_threads);
+    add(
+        prefix + "hidden_set_MAP",
+        [family](State &state) {
+          query(state, family,
+                [](model::RandomField &model, const categoric::VariablePtr &,
+                   std::size_t threads) {
+                  auto result = model.getHiddenSetMAP(threads);
+                  do_not_optimize(result);
+                });
+        },
+        ranges_threads);
+    add(
+        prefix + "samples",
+        [family, samples_number = config.samples](State &state) {
+          samples(state, family, samples_number);
+        },
+        ranges_threads);
+    add(
+        prefix + "gradient",
+        [family, samples_number = config.samples](State &state) {
+          gradient(state, family, samples_number);
+        },
+        ranges_threads);
+  }
+}
+
+// adds the speedup and efficiency of the runs using many threads, w.r.t. the
+// same run using a single thread.
+void compute_scaling(std::vector<Result> &results) {
+  std::map<std::string, double> single_thread_times;
+  auto is_multi_threads = [](const std::vector<std::string> &tokens) {
+    return (tokens.size() == 5) &&
+           (std::find(std::begin(THREADS_OPERATIONS),
+                      std::end(THREADS_OPERATIONS),
+                      tokens[1]) != std::end(THREADS_OPERATIONS));
+  };
+  auto key_of = [](const std::string &name) {
+    return name.substr(0, name.rfind('/'));
+  };
+  for (const auto &result : results) {
+    auto tokens = split(result.name, '/');
+    if (is_multi_threads(tokens) && (tokens.back() == "1")) {
+      single_thread_times[key_of(result.name)] = result.real_time_ns;
+    }
+  }
+  bool header_printed = false;
+  for (auto &result : results) {
+    auto tokens = split(result.name, '/');
+    if (!is_multi_threads(tokens)) {
+      continue;
+    }
+    auto it = single_thread_times.find(key_of(result.name));
+    if ((it == single_thread_times.end()) || (0 == result.real_time_ns)) {
+      continue;
+    }
+    const double threads = std::stod(tokens.back());
+    const double speedup = it->second / result.real_time_ns;
+    result.counters["speedup"] = speedup;
+    result.counters["efficiency"] = speedup / threads;
+    if (!header_printed) {
+      std::cout << std::endl << "Scaling w.r.t. single thread" << std::endl;
+      header_printed = true;
+    }
+    std::cout << std::left << std::setw(50) << result.name << std::right
+              << std::fixed << std::setprecision(2) << "  speedup=" << speedup
+              << "  efficiency=" << speedup / threads << std::defaultfloat
+              << std::endl;
+  }
+}
+} // namespace
+
+int main(int argc, const char **argv) {
+  try {
+    register_all(parse_configuration(argc, argv));
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return run(argc, argv, compute_scaling);
+}
@@ -0,0 +1,272 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#include "Benchmark.h"
+
+#include <EasyFactorGraph/Error.h>
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+namespace EFG::bench {
+State::State(const std::vector<std::size_t> &ranges, std::size_t iterations)
+    : ranges(ranges), iterations_(iterations) {}
+
+std::size_t State::range(std::size_t pos) const {
+  if (ranges.size() <= pos) {
+    throw Error::make("Benchmark parameter ", pos, " is not available");
+  }
+  return ranges[pos];
+}
+
+void State::start() {
+  done = 0;
+  elapsed_ = std::chrono::nanoseconds{0};
+  resumeTiming();
+}
+
+void State::stop() { pauseTiming(); }
+
+void State::pauseTiming() {
+  if (!running) {
+    return;
+  }
+  elapsed_ += std::chrono::duration_cast<std::chrono::nanoseconds>(
+      Clock::now() - tic);
+  running = false;
+}
+
+void State::resumeTiming() {
+  if (running) {
+    return;
+  }
+  running = true;
+  tic = Clock::now();
+}
+
+namespace {
+struct Registered {
+  std::string name;
+  Body body;
+  std::vector<std::size_t> ranges;
+};
+
+std::vector<Registered> &get_registered() {
+  static std::vector<Registered> registered;
+  return registered;
+}
+
+std::string make_name(const std::string &name,
+                      const std::vector<std::size_t> &ranges) {
+  std::string result = name;
+  for (auto r : ranges) {
+    result += '/';
+    result += std::to_string(r);
+  }
+  return result;
+}
+
+struct Options {
+  std::string filter;
+  double min_time_seconds = 0.2;
+  std::string out;
+  std::string out_format = "json";
+};
+
+Options parse_options(int argc, const char **argv) {
+  Options result;
+  auto extract = [](const std::string &arg,
+                    const std::string &prefix) -> const char * {
+    if (arg.rfind(prefix, 0) == 0) {
+      return arg.c_str() + prefix.size();
+    }
+    return nullptr;
+  };
+  for (int k = 1; k < argc; ++k) {
+    const std::string arg = argv[k];
+    if (const char *val = extract(arg, "--benchmark_filter="); val) {
+      result.filter = val;
+    } else if (const char *val = extract(arg, "--benchmark_min_time="); val) {
+      result.min_time_seconds = std::atof(val);
+    } else if (const char *val = extract(arg, "--benchmark_out="); val) {
+      result.out = val;
+    } else if (const char *val = extract(arg, "--benchmark_out_format=");
+               val) {
+      result.out_format = val;
+      if ((result.out_format != "json") && (result.out_format != "csv")) {
+        throw Error::make(result.out_format, " is an unknown output format");
+      }
+    } else if (arg.rfind("--benchmark_", 0) == 0) {
+      throw Error::make(arg, " is an unknown option");
+    }
+    // options not starting with --benchmark_ are left to the caller
+  }
+  return result;
+}
+
+static constexpr std::size_t MAX_ITERATIONS = 1000000000;
+
+Result measure(const Registered &subject, const Options &options) {
+  const auto min_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::duration<double>{options.min_time_seconds});
+  std::size_t iterations = 1;
+  while (true) {
+    State state{subject.ranges, iterations};
+    subject.body(state);
+    const auto elapsed = state.elapsed();
+    if ((min_time <= elapsed) || (MAX_ITERATIONS <= iterations)) {
+      Result result;
+      result.name = make_name(subject.name, subject.ranges);
+      result.iterations = iterations;
+      result.real_time_ns = static_cast<double>(elapsed.count()) /
+                            static_cast<double>(iterations);
+      result.items_per_second =
+          (0 == elapsed.count())
+              ? 0
+              : static_cast<double>(state.itemsProcessed()) * 1e9 /
+                    static_cast<double>(elapsed.count());
+      result.counters = state.getCounters();
+      return result;
+    }
+    // same heuristic adopted by google-benchmark
+    double multiplier = 10.0;
+    if (0 < elapsed.count()) {
+      multiplier = std::clamp(1.4 * static_cast<double>(min_time.count()) /
+                                  static_cast<double>(elapsed.count()),
+                              2.0, 10.0);
+    }
+    iterations = std::min<std::size_t>(
+        MAX_ITERATIONS,
+        static_cast<std::size_t>(static_cast<double>(iterations) * multiplier));
+  }
+}
+
+void print(std::ostream &recipient, const Result &result) {
+  recipient << std::left << std::setw(50) << result.name << std::right
+            << std::setw(14) << std::fixed << std::setprecision(1)
+            << result.real_time_ns << " ns" << std::setw(12)
+            << result.iterations;
+  if (0 < result.items_per_second) {
+    recipient << "  items/s=" << std::scientific << std::setprecision(3)
+              << result.items_per_second;
+  }
+  for (const auto &[name, value] : result.counters) {
+    recipient << "  " << name << '=' << std::defaultfloat << value;
+  }
+  recipient << std::defaultfloat << std::endl;
+}
+} // namespace
+
+void add(const std::string &name, const Body &body,
+         const std::vector<std::vector<std::size_t>> &ranges) {
+  for (const auto &r : ranges) {
+    get_registered().push_back(Registered{name, body, r});
+  }
+}
+
+void to_json(std::ostream &recipient, const std::vector<Result> &results) {
+  auto now = std::time(nullptr);
+  char date[64];
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S",
+                std::localtime(&now));
+  recipient << "{\n  \"context\": {\n";
+  recipient << "    \"date\": \"" << date << "\",\n";
+  recipient << "    \"num_cpus\": " << std::thread::hardware_concurrency()
+            << "\n  },\n";
+  recipient << "  \"benchmarks\": [";
+  for (std::size_t k = 0; k < results.size(); ++k) {
+    const auto &result = results[k];
+    recipient << ((0 == k) ? "\n" : ",\n");
+    recipient << "    {\n";
+    recipient << "      \"name\": \"" << result.name << "\",\n";
+    recipient << "      \"iterations\": " << result.iterations << ",\n";
+    recipient << "      \"real_time\": " << std::setprecision(12)
+              << result.real_time_ns << ",\n";
+    recipient << "      \"time_unit\": \"ns\"";
+    if (0 < result.items_per_second) {
+      recipient << ",\n      \"items_per_second\": "
+                << result.items_per_second;
+    }
+    for (const auto &[name, value] : result.counters) {
+      recipient << ",\n      \"" << name << "\": " << value;
+    }
+    recipient << "\n    }";
+  }
+  recipient << "\n  ]\n}\n";
+}
+
+void to_csv(std::ostream &recipient, const std::vector<Result> &results) {
+  std::vector<std::string> counters;
+  for (const auto &result : results) {
+    for (const auto &[name, value] : result.counters) {
+      if (std::find(counters.begin(), counters.end(), name) == counters.end()) {
+        counters.push_back(name);
+      }
+    }
+  }
+  recipient << "name,iterations,real_time,time_unit,items_per_second";
+  for (const auto &name : counters) {
+    recipient << ',' << name;
+  }
+  recipient << '\n';
+  for (const auto &result : results) {
+    recipient << '"' << result.name << "\"," << result.iterations << ','
+              << std::setprecision(12) << result.real_time_ns << ",ns,";
+    if (0 < result.items_per_second) {
+      recipient << result.items_per_second;
+    }
+    for (const auto &name : counters) {
+      recipient << ',';
+      if (auto it = result.counters.find(name); it != result.counters.end()) {
+        recipient << it->second;
+      }
+    }
+    recipient << '\n';
+  }
+}
+
+int run(int argc, const char **argv, const PostProcessing &post_processing) {
+  try {
+    const auto options = parse_options(argc, argv);
+    std::vector<Result> results;
+    for (const auto &subject : get_registered()) {
+      if (make_name(subject.name, subject.ranges).find(options.filter) ==
+          std::string::npos) {
+        continue;
+      }
+      print(std::cout, results.emplace_back(measure(subject, options)));
+    }
+    if (post_processing) {
+      post_processing(results);
+    }
+    if (!options.out.empty()) {
+      std::ofstream stream{options.out};
+      if (!stream.is_open()) {
+        throw Error::make(options.out, " is a non valid file path");
+      }
+      if (options.out_format == "csv") {
+        to_csv(stream, results);
+      } else {
+        to_json(stream, results);
+      }
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+void escape(const void *ptr) {
+  static const void *volatile sink;
+  sink = ptr;
+}
+} // namespace EFG::bench
@@ -0,0 +1,157 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace EFG::bench {
+/**
+ * @brief Handle passed to every benchmark body, mimicking the one of
+ * google-benchmark. The body should put the code to measure inside a loop like
+ * this one:
+ *
+ * for (auto _ : state) {
+ *   ... code to measure ...
+ * }
+ *
+ * The number of iterations is decided by the runner, in order to cover at
+ * least the minimum measuring time.
+ */
+class State {
+public:
+  State(const std::vector<std::size_t> &ranges, std::size_t iterations);
+
+  /**
+   * @return the value of the parameter in the specified position.
+   */
+  std::size_t range(std::size_t pos = 0) const;
+
+  /**
+   * @brief excludes from the measured time what is executed till the next
+   * resumeTiming().
+   */
+  void pauseTiming();
+  void resumeTiming();
+
+  /**
+   * @brief number of processed elements, used to compute the throughput.
+   */
+  void setItemsProcessed(std::size_t items) { items_processed = items; }
+
+  /**
+   * @brief adds a custom quantity to report together with the timings.
+   */
+  void setCounter(const std::string &name, double value) {
+    counters[name] = value;
+  }
+
+  struct Sentinel {};
+  class Iterator {
+  public:
+    Iterator(State &subject) : subject(subject) {}
+
+    Iterator &operator++() {
+      ++subject.done;
+      return *this;
+    }
+    bool operator!=(const Sentinel &) {
+      if (subject.done < subject.iterations_) {
+        return true;
+      }
+      subject.stop();
+      return false;
+    }
+    int operator*() const { return 0; }
+
+  private:
+    State &subject;
+  };
+
+  Iterator begin() {
+    start();
+    return Iterator{*this};
+  }
+  Sentinel end() const { return Sentinel{}; }
+
+  std::size_t iterations() const { return iterations_; }
+  std::chrono::nanoseconds elapsed() const { return elapsed_; }
+  std::size_t itemsProcessed() const { return items_processed; }
+  const std::map<std::string, double> &getCounters() const { return counters; }
+
+private:
+  void start();
+  void stop();
+
+  const std::vector<std::size_t> ranges;
+  const std::size_t iterations_;
+  std::size_t done = 0;
+
+  using Clock = std::chrono::high_resolution_clock;
+  Clock::time_point tic;
+  bool running = false;
+  std::chrono::nanoseconds elapsed_ = std::chrono::nanoseconds{0};
+
+  std::size_t items_processed = 0;
+  std::map<std::string, double> counters;
+};
+
+using Body = std::function<void(State &)>;
+
+/**
+ * @brief registers a benchmark to run for each of the passed set of parameters.
+ * The name of each run is obtained by appending the parameters to the passed
+ * name, like: name/param_0/param_1
+ */
+void add(const std::string &name, const Body &body,
+         const std::vector<std::vector<std::size_t>> &ranges = {{}});
+
+struct Result {
+  std::string name;
+  std::size_t iterations;
+  double real_time_ns; // per iteration
+  double items_per_second;
+  std::map<std::string, double> counters;
+};
+
+/**
+ * @brief called after all the benchmarks were measured and before exporting
+ * the results, allowing to add counters depending on many runs.
+ */
+using PostProcessing = std::function<void(std::vector<Result> &)>;
+
+/**
+ * @brief Mirrors the command line options of google-benchmark:
+ * --benchmark_filter=<sub string to match in the benchmark names>
+ * --benchmark_min_time=<minimum seconds to spend measuring each run>
+ * --benchmark_out=<file where to write the results>
+ * --benchmark_out_format=<json or csv, json by default>
+ * Results are also always printed on the console.
+ * Options not starting with --benchmark_ are ignored, as they might be
+ * consumed by the specific benchmark program.
+ */
+int run(int argc, const char **argv,
+        const PostProcessing &post_processing = nullptr);
+
+void to_json(std::ostream &recipient, const std::vector<Result> &results);
+
+void to_csv(std::ostream &recipient, const std::vector<Result> &results);
+
+void escape(const void *ptr);
+
+/**
+ * @brief prevents the compiler from optimizing away the passed value.
+ */
+template <typename T> void do_not_optimize(const T &value) {
+  escape(static_cast<const void *>(&value));
+}
+} // namespace EFG::bench
@@ -0,0 +1,182 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#include "Graphs.h"
+
+#include <EasyFactorGraph/Error.h>
+
+#include <cmath>
+#include <random>
+#include <set>
+
+namespace EFG::bench {
+std::string to_string(GraphFamily family) {
+  switch (family) {
+  case GraphFamily::CHAIN:
+    return "chain";
+  case GraphFamily::GRID:
+    return "grid";
+  case GraphFamily::TREE:
+    return "tree";
+  case GraphFamily::SCALE_FREE:
+    return "scale_free";
+  }
+  return "";
+}
+
+GraphFamily family_from_string(const std::string &name) {
+  for (auto family : {GraphFamily::CHAIN, GraphFamily::GRID, GraphFamily::TREE,
+                      GraphFamily::SCALE_FREE}) {
+    if (to_string(family) == name) {
+      return family;
+    }
+  }
+  throw Error::make(name, " is not a valid graph family");
+}
+
+namespace {
+using Engine = std::mt19937;
+
+void add_variables(GraphDescription &recipient, std::size_t number,
+                   std::size_t domain, const std::string &prefix) {
+  for (std::size_t k = 0; k < number; ++k) {
+    recipient.variables.push_back(
+        categoric::make_variable(domain, prefix + std::to_string(k)));
+  }
+}
+
+void make_chain(GraphDescription &recipient, std::size_t size,
+                std::size_t domain) {
+  const std::size_t chain_size = std::max<std::size_t>(2, size / 2);
+  // Y_k are the hidden variables in [0, chain_size), X_k the observations in
+  // [chain_size, 2 * chain_size)
+  add_variables(recipient, chain_size, domain, "Y_");
+  add_variables(recipient, chain_size, domain, "X_");
+  for (std::size_t k = 0; k < chain_size; ++k) {
+    if (0 < k) {
+      recipient.edges.emplace_back(k - 1, k);
+    }
+    recipient.edges.emplace_back(k, chain_size + k);
+    recipient.observed.push_back(chain_size + k);
+  }
+}
+
+void make_grid(GraphDescription &recipient, std::size_t size,
+               std::size_t domain) {
+  const std::size_t side = std::max<std::size_t>(
+      2, static_cast<std::size_t>(std::round(std::sqrt(size))));
+  for (std::size_t row = 0; row < side; ++row) {
+    for (std::size_t col = 0; col < side; ++col) {
+      recipient.variables.push_back(categoric::make_variable(
+          domain, "V" + std::to_string(row) + "_" + std::to_string(col)));
+      const std::size_t pos = row * side + col;
+      if (0 < col) {
+        recipient.edges.emplace_back(pos - 1, pos);
+      }
+      if (0 < row) {
+        recipient.edges.emplace_back(pos - side, pos);
+      }
+    }
+  }
+}
+
+void make_tree(GraphDescription &recipient, std::size_t size,
+               std::size_t domain, Engine &engine) {
+  size = std::max<std::size_t>(2, size);
+  add_variables(recipient, size, domain, "V");
+  for (std::size_t k = 1; k < size; ++k) {
+    std::uniform_int_distribution<std::size_t> parent(0, k - 1);
+    recipient.edges.emplace_back(parent(engine), k);
+  }
+}
+
+void make_scale_free(GraphDescription &recipient, std::size_t size,
+                     std::size_t domain, Engine &engine) {
+  static constexpr std::size_t NEW_EDGES = 2;
+  size = std::max<std::size_t>(NEW_EDGES + 1, size);
+  add_variables(recipient, size, domain, "V");
+  // every node appears in this collection as many times as its degree, in
+  // order to sample proportionally to it
+  std::vector<std::size_t> ends;
+  for (std::size_t a = 0; a <= NEW_EDGES; ++a) {
+    for (std::size_t b = a + 1; b <= NEW_EDGES; ++b) {
+      recipient.edges.emplace_back(a, b);
+      ends.push_back(a);
+      ends.push_back(b);
+    }
+  }
+  for (std::size_t k = NEW_EDGES + 1; k < size; ++k) {
+    std::set<std::size_t> targets;
+    std::uniform_int_distribution<std::size_t> pick(0, ends.size() - 1);
+    while (targets.size() < NEW_EDGES) {
+      targets.emplace(ends[pick(engine)]);
+    }
+    for (auto target : targets) {
+      recipient.edges.emplace_back(target, k);
+      ends.push_back(target);
+      ends.push_back(k);
+    }
+  }
+}
+} // namespace
+
+GraphDescription make_graph_description(GraphFamily family, std::size_t size,
+                                        std::size_t domain, std::size_t seed) {
+  if (domain < 2) {
+    throw Error{"invalid variable size"};
+  }
+  Engine engine(static_cast<Engine::result_type>(seed));
+  GraphDescription result;
+  switch (family) {
+  case GraphFamily::CHAIN:
+    make_chain(result, size, domain);
+    break;
+  case GraphFamily::GRID:
+    make_grid(result, size, domain);
+    break;
+  case GraphFamily::TREE:
+    make_tree(result, size, domain, engine);
+    break;
+  case GraphFamily::SCALE_FREE:
+    make_scale_free(result, size, domain, engine);
+    break;
+  }
+  if (result.observed.empty()) {
+    // one variable every 10 is an evidence
+    for (std::size_t k = 0; k < result.variables.size(); k += 10) {
+      result.observed.push_back(k);
+    }
+  }
+  std::uniform_real_distribution<float> weight(0.5f, 1.5f);
+  for (std::size_t k = 0; k < result.edges.size(); ++k) {
+    result.weights.push_back(weight(engine));
+  }
+  return result;
+}
+
+std::unique_ptr<model::RandomField>
+make_model(const GraphDescription &description) {
+  auto result = std::make_unique<model::RandomField>();
+  for (std::size_t k = 0; k < description.edges.size(); ++k) {
+    const auto &[a, b] = description.edges[k];
+    factor::Factor correlating{
+        categoric::VariablesSoup{description.variables[a],
+                                 description.variables[b]},
+        factor::Factor::SimplyCorrelatedTag{}};
+    result->addTunableFactor(std::make_shared<factor::FactorExponential>(
+        correlating, description.weights[k]));
+  }
+  return result;
+}
+
+void set_evidences(model::RandomField &model,
+                   const GraphDescription &description, std::size_t value) {
+  for (auto pos : description.observed) {
+    model.setEvidence(description.variables[pos], value);
+  }
+}
+} // namespace EFG::bench
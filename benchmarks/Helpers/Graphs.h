@@ -0,0 +1,67 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#pragma once
+
+#include <EasyFactorGraph/model/RandomField.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace EFG::bench {
+enum class GraphFamily {
+  // hidden chain with an observation attached to each hidden variable, like
+  // the one of Sample04-HMM-chain
+  CHAIN,
+  // squared matrix of variables, like the one of Sample05-Matricial
+  GRID,
+  // every new variable is attached to a random previous one
+  TREE,
+  // Barabasi-Albert graph: every new variable is attached to 2 previous ones,
+  // chosen proportionally to their degree. It contains loops.
+  SCALE_FREE
+};
+
+std::string to_string(GraphFamily family);
+GraphFamily family_from_string(const std::string &name);
+
+struct GraphDescription {
+  categoric::VariablesSoup variables;
+  // positions in variables of the connected pairs
+  std::vector<std::pair<std::size_t, std::size_t>> edges;
+  // positions in variables of the ones to use as evidences
+  std::vector<std::size_t> observed;
+  // weight to assign to the factor associated to each edge
+  std::vector<float> weights;
+};
+
+/**
+ * @param the family of the graph to generate
+ * @param the (approximated) number of variables of the graph
+ * @param the size of the domain of all the variables
+ * @param seed used to randomly generate the topology and the weights
+ */
+GraphDescription make_graph_description(GraphFamily family, std::size_t size,
+                                        std::size_t domain,
+                                        std::size_t seed = 0);
+
+/**
+ * @brief builds a model having a tunable exponential factor for each edge of
+ * the passed description. Evidences are not set.
+ */
+std::unique_ptr<model::RandomField>
+make_model(const GraphDescription &description);
+
+/**
+ * @brief sets the evidences specified by the description, all equal to the
+ * passed value.
+ */
+void set_evidences(model::RandomField &model,
+                   const GraphDescription &description, std::size_t value = 0);
+} // namespace EFG::bench
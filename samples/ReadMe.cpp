@@ -167,7 +167,7 @@ int main() {
         };
 
     // get samples from the model using Gibbs sampler
-    std::vector<std::vector<std::size_t>> samples =
+    CombinationMatrix samples =
         model.makeSamples(info,
                           4 // threads to use
         );
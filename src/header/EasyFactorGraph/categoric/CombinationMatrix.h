@@ -0,0 +1,200 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace EFG::categoric {
+/**
+ * @brief A collection of combinations having all the same size, stored as the
+ * rows of a row-major matrix inside a single contiguous buffer.
+ *
+ * Values are stored using the smallest width (1, 2, 4 or 8 bytes) able to
+ * represent the biggest value ever added. When a bigger value is added, the
+ * values already stored are re-encoded using a wider representation.
+ *
+ * Compared to a std::vector<std::vector<std::size_t>>, no allocation is done
+ * per row and a combination of variables with less than 256 values takes
+ * 1 byte per variable.
+ *
+ * The values can be also aliased from a buffer handled by someone else, like
+ * a memory mapped file. Similarly to factor::DenseImages, such buffer is never
+ * modified: the first addition makes a private copy of it.
+ */
+class CombinationMatrix {
+public:
+  /**
+   * @brief a view of a row of the matrix, i.e. a combination.
+   * It is invalidated by any addition to the matrix it refers to.
+   */
+  class Row {
+  public:
+    std::size_t size() const { return size_; }
+
+    std::size_t operator[](std::size_t pos) const {
+      switch (width_) {
+      case 1:
+        return data_[pos];
+      case 2:
+        return read<std::uint16_t>(pos);
+      case 4:
+        return read<std::uint32_t>(pos);
+      default:
+        return read<std::uint64_t>(pos);
+      }
+    }
+
+    /**
+     * @return the bytes storing this row: rows of the same matrix are equal
+     * if and only if they have the same bytes.
+     */
+    std::string_view bytes() const {
+      return std::string_view{reinterpret_cast<const char *>(data_),
+                              size_ * width_};
+    }
+
+    operator std::vector<std::size_t>() const {
+      std::vector<std::size_t> result;
+      result.reserve(size_);
+      for (std::size_t k = 0; k < size_; ++k) {
+        result.push_back((*this)[k]);
+      }
+      return result;
+    }
+
+  private:
+    friend class CombinationMatrix;
+    Row(const std::uint8_t *data, std::size_t width, std::size_t size)
+        : data_{data}, width_{width}, size_{size} {}
+
+    template <typename T> std::size_t read(std::size_t pos) const {
+      T value;
+      std::memcpy(&value, data_ + pos * sizeof(T), sizeof(T));
+      return static_cast<std::size_t>(value);
+    }
+
+    const std::uint8_t *data_;
+    std::size_t width_;
+    std::size_t size_;
+  };
+
+  class Iterator {
+  public:
+    Row operator*() const { return (*subject)[row]; }
+
+    Iterator &operator++() {
+      ++row;
+      return *this;
+    }
+
+    bool operator==(const Iterator &o) const { return row == o.row; }
+    bool operator!=(const Iterator &o) const { return row != o.row; }
+
+  private:
+    friend class CombinationMatrix;
+    Iterator(const CombinationMatrix &subject, std::size_t row)
+        : subject{&subject}, row{row} {}
+
+    const CombinationMatrix *subject;
+    std::size_t row;
+  };
+
+  /**
+   * @param the size of the combinations to store
+   * @param the biggest value expected to be stored, used to choose the
+   * initial width of the stored values.
+   */
+  CombinationMatrix(std::size_t columns, std::size_t max_value = 0);
+
+  /**
+   * @throw if the combinations don't have all the same size
+   */
+  CombinationMatrix(const std::vector<std::vector<std::size_t>> &combinations);
+
+  /**
+   * @param whatever keeps the aliased buffer valid
+   * @param the first byte of the aliased buffer, storing the rows one after
+   * the other
+   * @param the number of rows
+   * @param the size of the combinations
+   * @param the number of bytes used to store every value
+   * @throw if the width is not 1, 2, 4 or 8
+   */
+  CombinationMatrix(std::shared_ptr<const void> owner,
+                    const std::uint8_t *buffer, std::size_t rows,
+                    std::size_t columns, std::size_t width);
+
+  std::size_t columns() const { return columns_; }
+
+  /**
+   * @return the number of rows
+   */
+  std::size_t size() const { return rows_; }
+  bool empty() const { return rows_ == 0; }
+
+  /**
+   * @return the number of bytes used to store every value
+   */
+  std::size_t width() const { return width_; }
+
+  bool isAliased() const { return owner_ != nullptr; }
+
+  /**
+   * @return the bytes storing all the rows, one after the other
+   */
+  std::string_view bytes() const {
+    return std::string_view{reinterpret_cast<const char *>(data()),
+                            rows_ * columns_ * width_};
+  }
+
+  void reserve(std::size_t rows) {
+    detach();
+    buffer_.reserve(rows * columns_ * width_);
+  }
+
+  /**
+   * @brief adds a row at the end of the matrix. The passed row can also be
+   * one of this matrix.
+   * @throw if the passed combination has a size different from columns()
+   */
+  void push_back(const std::vector<std::size_t> &combination);
+  void push_back(const Row &combination);
+
+  Row operator[](std::size_t row) const {
+    return Row{data() + row * columns_ * width_, width_, columns_};
+  }
+
+  Iterator begin() const { return Iterator{*this, 0}; }
+  Iterator end() const { return Iterator{*this, rows_}; }
+
+  operator std::vector<std::vector<std::size_t>>() const;
+
+private:
+  template <typename Combination>
+  void push_back_(const Combination &combination);
+
+  void widen(std::size_t max_value);
+
+  const std::uint8_t *data() const {
+    return isAliased() ? aliased_ : buffer_.data();
+  }
+
+  void detach();
+
+  std::size_t columns_;
+  std::size_t rows_ = 0;
+  std::size_t width_ = 1;
+  std::vector<std::uint8_t> buffer_;
+  std::shared_ptr<const void> owner_;
+  const std::uint8_t *aliased_ = nullptr;
+};
+} // namespace EFG::categoric
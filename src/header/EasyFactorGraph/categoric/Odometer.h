@@ -0,0 +1,96 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+namespace EFG::categoric {
+/**
+ * @brief Lightweight alternative to GroupRange, iterating the elements of a
+ * joint domain in the same order. Differently from GroupRange:
+ * - the sizes of the variables are not copied, but only referred: they must
+ * outlive this object
+ * - the end of the iteration is detected by comparing a flat counter
+ * - the iteration can be limited to a contiguous portion of the joint domain,
+ * i.e. [begin, end) in terms of flat indices, which allows to split the domain
+ * among many workers (see partition_domain)
+ *
+ * The only allocation happens at construction, to store the current
+ * combination.
+ */
+class Odometer {
+public:
+  /**
+   * @brief iterates the entire joint domain.
+   */
+  Odometer(const std::vector<std::size_t> &sizes);
+
+  /**
+   * @brief iterates the combinations having a flat index in [begin, end).
+   * @throw if end is smaller than begin or bigger than the domain size
+   */
+  Odometer(const std::vector<std::size_t> &sizes, std::size_t begin,
+           std::size_t end);
+
+  const std::vector<std::size_t> &combination() const { return combination_; }
+
+  /**
+   * @return the position of the current combination in the joint domain.
+   */
+  std::size_t flat() const { return counter; }
+
+  bool done() const { return counter == end; }
+
+  void next() {
+    ++counter;
+    for (std::size_t k = combination_.size(); k > 0; --k) {
+      if (++combination_[k - 1] < (*sizes)[k - 1]) {
+        return;
+      }
+      combination_[k - 1] = 0;
+    }
+  }
+
+  /**
+   * @brief moves to the combination with the passed flat index.
+   */
+  void seek(std::size_t flat);
+
+private:
+  const std::vector<std::size_t> *sizes;
+  std::vector<std::size_t> combination_;
+  std::size_t counter;
+  std::size_t end;
+};
+
+/**
+ * @return the number of elements in the joint domain of variables having the
+ * passed sizes.
+ */
+std::size_t domain_size(const std::vector<std::size_t> &sizes);
+
+/**
+ * @brief splits [0, domain_size) into (at most) the specified number of
+ * contiguous chunks, having almost the same size.
+ * @return the [begin, end) of every chunk
+ */
+std::vector<std::pair<std::size_t, std::size_t>>
+partition_domain(std::size_t domain_size, std::size_t chunks);
+
+/**
+ * @brief Applies the passed predicate to all the remaining elements of the
+ * passed odometer.
+ */
+template <typename Predicate>
+void for_each_combination(Odometer &range, const Predicate &predicate) {
+  for (; !range.done(); range.next()) {
+    predicate(range.combination());
+  }
+}
+} // namespace EFG::categoric
@@ -11,6 +11,15 @@
 #include <string>
 
 namespace EFG::categoric {
+/**
+ * @brief The name of a variable, shared by all the alive variables having that
+ * name.
+ */
+struct InternedName {
+  std::string name;
+  std::size_t id;
+};
+
 /**
  * @brief An object representing an immutable categoric variable.
  */
@@ -25,7 +34,16 @@ public:
   Variable(std::size_t size, const std::string &name);
 
   std::size_t size() const { return this->size_; };
-  const std::string &name() const { return this->name_; };
+  const std::string &name() const { return this->name_->name; };
+
+  /**
+   * @return an integer identifying the name of this variable. Names are
+   * interned when creating variables: all the alive variables having the same
+   * name share the same id. An interned name is released as soon as the last
+   * variable having it is destroyed: a variable created later with the same
+   * name may then get a different id.
+   */
+  std::size_t nameId() const { return this->name_->id; };
 
   bool operator==(const Variable &o) const {
     return (this->name_ == o.name_) && (this->size_ == o.size_);
@@ -33,7 +51,7 @@ public:
 
 protected:
   const size_t size_;
-  const std::string name_;
+  const std::shared_ptr<const InternedName> name_;
 };
 
 using VariablePtr = std::shared_ptr<Variable>;
@@ -44,7 +62,7 @@ VariablePtr make_variable(std::size_t size, const std::string &name);
 namespace std {
 template <> struct hash<EFG::categoric::Variable> {
   std::size_t operator()(const EFG::categoric::Variable &subject) const {
-    return std::hash<std::string>{}(subject.name());
+    return subject.nameId();
   }
 };
 } // namespace std
@@ -0,0 +1,75 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+namespace EFG::factor {
+/**
+ * @brief The images of a dense function. They can be either owned, or aliased
+ * from a buffer handled by someone else, like a memory mapped file: the owner
+ * of such buffer is kept alive as long as this object (or any copy of it) is
+ * alive.
+ *
+ * Aliased images are never modified: the first non const access makes a
+ * private copy of them (copy on write).
+ */
+class DenseImages {
+public:
+  DenseImages() = default;
+
+  DenseImages(std::vector<float> images) : owned_{std::move(images)} {}
+
+  /**
+   * @param whatever keeps the aliased buffer valid
+   * @param the first aliased image
+   * @param the number of aliased images
+   */
+  DenseImages(std::shared_ptr<const void> owner, const float *images,
+              std::size_t size)
+      : owner_{std::move(owner)}, aliased_{images}, aliased_size_{size} {}
+
+  bool isAliased() const { return owner_ != nullptr; }
+
+  std::size_t size() const {
+    return isAliased() ? aliased_size_ : owned_.size();
+  }
+
+  const float *data() const { return isAliased() ? aliased_ : owned_.data(); }
+  float *data() {
+    detach();
+    return owned_.data();
+  }
+
+  const float *begin() const { return data(); }
+  const float *end() const { return data() + size(); }
+  float *begin() { return data(); }
+  float *end() { return data() + size(); }
+
+  float operator[](std::size_t pos) const { return data()[pos]; }
+  float &operator[](std::size_t pos) { return data()[pos]; }
+
+  operator std::vector<float>() const { return {begin(), end()}; }
+
+private:
+  void detach() {
+    if (isAliased()) {
+      owned_.assign(aliased_, aliased_ + aliased_size_);
+      owner_.reset();
+      aliased_ = nullptr;
+      aliased_size_ = 0;
+    }
+  }
+
+  std::vector<float> owned_;
+  std::shared_ptr<const void> owner_;
+  const float *aliased_ = nullptr;
+  std::size_t aliased_size_ = 0;
+};
+} // namespace EFG::factor
@@ -10,6 +10,10 @@
 #include <EasyFactorGraph/factor/Immutable.h>
 #include <EasyFactorGraph/factor/Mutable.h>
 
+namespace EFG::strct {
+class Pool;
+}
+
 namespace EFG::factor {
 class Factor : public Immutable, public Mutable {
 public:
@@ -142,6 +146,12 @@ public:
 
   Factor(const std::vector<const Immutable *> &factors);
 
+  /**
+   * @brief Same as Factor(const std::vector<const Immutable *> &), splitting
+   * the computation among the threads of the passed pool.
+   */
+  Factor(const std::vector<const Immutable *> &factors, strct::Pool &pool);
+
   /**
    * @brief Generates a Factor similar to this one, permuting the group of
    * variables.
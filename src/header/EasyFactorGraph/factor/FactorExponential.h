@@ -10,6 +10,9 @@
 #include <EasyFactorGraph/factor/Factor.h>
 #include <EasyFactorGraph/factor/Immutable.h>
 #include <EasyFactorGraph/factor/Mutable.h>
+#include <EasyFactorGraph/factor/WeightsBuffer.h>
+
+#include <optional>
 
 namespace EFG::factor {
 /**
@@ -53,6 +56,23 @@ public:
    */
   float getWeight() const;
 
+  /**
+   * @brief binds the weight to a position of a buffer, possibly shared with
+   * other factors: from now on, the weight is the value stored in that
+   * position, which is also the one written by setWeight.
+   * Deep copies of this factor are not bound.
+   * @param the buffer storing the weight
+   * @param the position of the weight in the buffer
+   * @throw if the buffer is null or the position is out of it
+   */
+  void bindWeight(const WeightsBufferPtr &buffer, std::size_t position);
+
+  /**
+   * @return the buffer and the position the weight is bound to, or a nullopt
+   * when the weight was never bound.
+   */
+  std::optional<WeightSlot> getWeightSlot() const;
+
   using Mutable::replaceVariables;
 
 protected:
@@ -0,0 +1,138 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#pragma once
+
+#include <EasyFactorGraph/Error.h>
+#include <EasyFactorGraph/factor/Function.h>
+
+#include <array>
+
+namespace EFG::factor {
+/**
+ * @brief A dense snapshot of the images of a function defined over exactly N
+ * variables. Combinations are std::array, the strides to compute the position
+ * of a combination are computed once at construction and no dispatch is done
+ * on the kind of container, as images are always densely stored.
+ *
+ * Intended to be used in the hot paths dealing with unary and binary factors,
+ * like the messages computation.
+ */
+template <std::size_t N> class FixedArityFunction {
+  static_assert(0 < N, "at least one variable is required");
+
+public:
+  using Combination = std::array<std::size_t, N>;
+
+  /**
+   * @brief all images are assumed equal to 0.
+   * @param the domain sizes of the variables
+   */
+  FixedArityFunction(const Combination &sizes) : sizes_{sizes} {
+    std::size_t tot = 1;
+    for (std::size_t k = N; k > 0; --k) {
+      strides_[k - 1] = tot;
+      tot *= sizes_[k - 1];
+    }
+    images_.resize(tot, 0);
+  }
+
+  /**
+   * @brief copies the images of the passed function.
+   * @param the function to copy
+   * @param when true, the transformed images are copied (refer to
+   * Function::findTransformed), the raw ones in the contrary case.
+   * @throw in case the passed function is not defined over N variables
+   */
+  FixedArityFunction(const Function &source, bool use_transformed)
+      : FixedArityFunction{extract_sizes(source)} {
+    auto it = images_.begin();
+    auto copy = [&it](const std::vector<std::size_t> &, float img) {
+      *it = img;
+      ++it;
+    };
+    if (use_transformed) {
+      source.forEachCombination<true>(copy);
+    } else {
+      source.forEachCombination<false>(copy);
+    }
+  }
+
+  const Combination &sizes() const { return sizes_; }
+  const Combination &strides() const { return strides_; }
+
+  std::size_t position(const Combination &combination) const {
+    std::size_t result = 0;
+    for (std::size_t k = 0; k < N; ++k) {
+      result += combination[k] * strides_[k];
+    }
+    return result;
+  }
+
+  float findImage(const Combination &combination) const {
+    return images_[position(combination)];
+  }
+
+  void set(const Combination &combination, float image) {
+    images_[position(combination)] = image;
+  }
+
+  /**
+   * @brief images are ordered in the same way GroupRange iterates the joint
+   * domain.
+   */
+  const std::vector<float> &images() const { return images_; }
+  std::vector<float> &images() { return images_; }
+
+  // Pred(const Combination&, float)
+  template <typename Pred> void forEachCombination(Pred &&pred) const {
+    Combination combination;
+    combination.fill(0);
+    for (float img : images_) {
+      pred(static_cast<const Combination &>(combination), img);
+      for (std::size_t k = N; k > 0; --k) {
+        if (++combination[k - 1] < sizes_[k - 1]) {
+          break;
+        }
+        combination[k - 1] = 0;
+      }
+    }
+  }
+
+  /**
+   * @brief overwrites all the images of the passed function with the ones
+   * stored in this object.
+   * @throw in case the passed function has a different domain
+   */
+  void copyTo(Function &recipient) const {
+    if (extract_sizes(recipient) != sizes_) {
+      throw Error{"Function with a different domain"};
+    }
+    recipient.setDenseImages(images_);
+  }
+
+private:
+  static Combination extract_sizes(const Function &source) {
+    const auto &sizes = source.getInfo().sizes;
+    if (sizes.size() != N) {
+      throw Error::make("Function with ", std::to_string(sizes.size()),
+                        " variables can't be converted to a function with ",
+                        std::to_string(N), " variables");
+    }
+    Combination result{};
+    std::copy(sizes.begin(), sizes.end(), result.begin());
+    return result;
+  }
+
+  Combination sizes_;
+  Combination strides_{};
+  std::vector<float> images_;
+};
+
+using UnaryFunction = FixedArityFunction<1>;
+using BinaryFunction = FixedArityFunction<2>;
+} // namespace EFG::factor
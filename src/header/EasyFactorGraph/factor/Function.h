@@ -8,19 +8,30 @@
 #pragma once
 
 #include <EasyFactorGraph/categoric/GroupRange.h>
+#include <EasyFactorGraph/categoric/Odometer.h>
+#include <EasyFactorGraph/factor/DenseImages.h>
 #include <EasyFactorGraph/misc/Visitor.h>
 
+#include <mutex>
+#include <optional>
 #include <unordered_map>
 #include <variant>
 
 namespace EFG::factor {
+class ImageFinder;
+
 class Function {
+  friend class ImageFinder;
+
 public:
   Function(const categoric::Group &variables);
 
   virtual ~Function() = default;
 
-  void cloneImages(const Function &o) { data_ = o.data_; }
+  void cloneImages(const Function &o) {
+    data_ = o.data_;
+    imagesChanged();
+  }
 
   void set(const std::vector<std::size_t> &combination, float image);
 
@@ -28,12 +39,65 @@ public:
 
   float findImage(const std::vector<std::size_t> &combination) const;
 
-  void clear() { data_ = makeSparseContainer(); }
+  void clear() {
+    data_ = makeSparseContainer();
+    imagesChanged();
+  }
+
+  /**
+   * @brief replaces all the images at once, making this function dense.
+   * @param the new images, ordered in the same way combinations are iterated by
+   * forEachCombination
+   * @throw if the number of images is not equal to the number of combinations
+   */
+  void setDenseImages(std::vector<float> images);
+
+  /**
+   * @brief makes this function dense, aliasing images stored somewhere else
+   * instead of copying them. The aliased buffer is never modified: a private
+   * copy is made as soon as an image of this function is set.
+   * @param whatever keeps the aliased buffer valid: it is kept alive as long
+   * as this function (or any function cloning its images) is alive
+   * @param the images, ordered in the same way combinations are iterated by
+   * forEachCombination. There should be as many images as the number of
+   * combinations.
+   */
+  void aliasDenseImages(std::shared_ptr<const void> owner, const float *images);
+
+  /**
+   * @return the images, ordered in the same way combinations are iterated by
+   * forEachCombination, when this function is dense. nullptr otherwise.
+   */
+  const DenseImages *getDenseImages() const {
+    return std::get_if<DenseContainer>(&data_);
+  }
+
+  /**
+   * @return the transformed images (refer to findTransformed), densely stored
+   * and ordered in the same way combinations are iterated by
+   * forEachCombination. They are computed by the first call and then reused,
+   * until either an image or the transformation changes. Can be called by many
+   * threads at the same time.
+   */
+  std::shared_ptr<const std::vector<float>> getTransformedImages() const;
+
+  /**
+   * @return the number of explicitly stored combinations, when this function
+   * is sparse and all the other combinations have a null transformed image.
+   * std::nullopt otherwise.
+   */
+  std::optional<std::size_t> sparseNonNullSize() const {
+    const auto *c = std::get_if<SparseContainer>(&data_);
+    if ((c == nullptr) || (transform(0) != 0)) {
+      return std::nullopt;
+    }
+    return c->size();
+  }
 
   // Pred(const std::vector<std::size_t>&, float)
   template <bool UseTransformed, typename Pred>
   void forEachCombination(Pred &&pred) const {
-    categoric::GroupRange range{info->sizes};
+    categoric::Odometer range{info->sizes};
     VisitorConst<SparseContainer, DenseContainer>{
         [&](const SparseContainer &c) {
           categoric::for_each_combination(
@@ -75,7 +139,7 @@ public:
           }
         },
         [&](const DenseContainer &c) {
-          categoric::GroupRange range{info->sizes};
+          categoric::Odometer range{info->sizes};
           auto cIt = c.begin();
           categoric::for_each_combination(
               range, [&](const std::vector<std::size_t> &comb) {
@@ -94,6 +158,8 @@ public:
 
   struct Info {
     std::vector<std::size_t> sizes;
+    // position of a combination = sum_k combination[k] * strides[k]
+    std::vector<std::size_t> strides;
     std::size_t totCombinations;
 
     // something to dynamically pass from a sparse to a dense distribution when
@@ -123,14 +189,45 @@ protected:
    */
   virtual float transform(float input) const { return input; }
 
+  /**
+   * @return a value identifying the transformation applied by transform: the
+   * same images are always transformed in the same way, as long as this value
+   * doesn't change.
+   */
+  virtual float transformKey() const { return 0; }
+
+  /**
+   * @brief to call when data_ is directly modified by a derived class, after
+   * construction.
+   */
+  void imagesChanged() { ++images_version; }
+
   using SparseContainer =
       std::unordered_map<std::vector<std::size_t>, float, CombinationHasher>;
 
   SparseContainer makeSparseContainer();
 
-  using DenseContainer = std::vector<float>;
+  using DenseContainer = DenseImages;
 
   std::variant<SparseContainer, DenseContainer> data_;
+
+private:
+  std::size_t images_version = 0;
+
+  struct TransformedImagesCache {
+    TransformedImagesCache() = default;
+    // copies start with nothing cached
+    TransformedImagesCache(const TransformedImagesCache &) {}
+    TransformedImagesCache &operator=(const TransformedImagesCache &) {
+      return *this;
+    }
+
+    std::mutex mtx;
+    std::shared_ptr<const std::vector<float>> images;
+    std::size_t images_version = 0;
+    float transform_key = 0;
+  };
+  mutable TransformedImagesCache transformed_cache;
 };
 
 std::shared_ptr<const Function::Info> make_info(const categoric::Group &vars);
@@ -28,13 +28,18 @@ public:
    * contains the sub combination to search.
    * @return image associated to the passed combination
    */
-  float findTransformed(const std::vector<std::size_t> &comb) const {
-    return function_->findTransformed(extractSmallerCombination(comb));
-  }
+  float findTransformed(const std::vector<std::size_t> &comb) const;
 
-  float findImage(const std::vector<std::size_t> &comb) const {
-    return function_->findImage(extractSmallerCombination(comb));
-  }
+  float findImage(const std::vector<std::size_t> &comb) const;
+
+  /**
+   * @brief Batch version of findImage(const std::vector<std::size_t> &).
+   * @param the combinations referring to the bigger_group
+   * @param the recipient of the images: recipient[k] will store the image
+   * associated to combinations[k]
+   */
+  void findImages(const std::vector<std::vector<std::size_t>> &combinations,
+                  std::vector<float> &recipient) const;
 
 private:
   ImageFinder(std::shared_ptr<const Function> function,
@@ -42,8 +47,19 @@ private:
 
   std::shared_ptr<const Function> function_;
   std::vector<std::size_t> indices_in_bigger_group;
+  // strides of the function, in the same order of indices_in_bigger_group
+  std::vector<std::size_t> strides;
+
+  // position in the images of the function of the sub combination contained in
+  // the passed one
+  std::size_t flatIndex(const std::vector<std::size_t> &comb) const {
+    std::size_t result = 0;
+    for (std::size_t k = 0; k < strides.size(); ++k) {
+      result += comb[indices_in_bigger_group[k]] * strides[k];
+    }
+    return result;
+  }
 
-  std::vector<std::size_t>
-  extractSmallerCombination(const std::vector<std::size_t> &comb) const;
+  float findSparseImage(const std::vector<std::size_t> &comb) const;
 };
 } // namespace EFG::factor
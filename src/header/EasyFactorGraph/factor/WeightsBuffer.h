@@ -0,0 +1,72 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+namespace EFG::factor {
+/**
+ * @brief Contiguous weights, aligned to a cache line, shared by the
+ * exponential factors bound to them (refer to FactorExponential::bindWeight).
+ * Factors refer to their weight by position, so that the buffer can grow
+ * without invalidating them.
+ */
+class WeightsBuffer {
+public:
+  static constexpr std::size_t ALIGNMENT = 64;
+
+  WeightsBuffer() = default;
+  ~WeightsBuffer();
+
+  WeightsBuffer(const WeightsBuffer &) = delete;
+  WeightsBuffer &operator=(const WeightsBuffer &) = delete;
+
+  std::size_t size() const { return size_; }
+
+  float *data() { return values; }
+  const float *data() const { return values; }
+
+  float operator[](std::size_t pos) const { return values[pos]; }
+
+  void set(std::size_t pos, float weight) {
+    values[pos] = weight;
+    ++version_;
+  }
+
+  /**
+   * @brief to call after having changed some weights through data().
+   */
+  void markChanged() { ++version_; }
+
+  /**
+   * @return a counter increased every time some weights are changed, allowing
+   * the many users of the buffer to detect the changes done by the others.
+   */
+  std::size_t version() const { return version_; }
+
+  /**
+   * @brief appends a weight at the end of the buffer.
+   * @return the position of the added weight
+   */
+  std::size_t push_back(float weight);
+
+private:
+  float *values = nullptr;
+  std::size_t size_ = 0;
+  std::size_t capacity = 0;
+  std::size_t version_ = 0;
+};
+
+using WeightsBufferPtr = std::shared_ptr<WeightsBuffer>;
+
+struct WeightSlot {
+  WeightsBufferPtr buffer;
+  std::size_t position;
+};
+} // namespace EFG::factor
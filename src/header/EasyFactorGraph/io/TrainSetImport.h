@@ -16,7 +16,7 @@ namespace EFG::io {
  * @brief Imports the training set from a file.
  * The file should be a matrix of raw values.
  * Each row represent a combination, i.e. a element of the training set to
- * import.
+ * import, while empty lines are ignored.
  * @throw in case the passed file is inexistent
  * @throw in case not all the combinations in file have the same size.
  */
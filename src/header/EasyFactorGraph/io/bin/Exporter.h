@@ -0,0 +1,45 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#pragma once
+
+#include <EasyFactorGraph/io/ModelComponents.h>
+
+#include <filesystem>
+
+namespace EFG::io::bin {
+/**
+ * @brief Exports models in a versioned binary format, made of:
+ * - an header, with the version and the number of elements in each section
+ * - a table of variables (sizes and names)
+ * - the evidences
+ * - a table of factor headers: kind (const, const exponential or tunable),
+ * variables, weight, the factor sharing the weight (if any) and the position
+ * of the images
+ * - the dense images of every factor, each block aligned to 64 bytes
+ *
+ * All the values are stored using the endianess of the machine generating the
+ * file. Such a file can be efficiently loaded by bin::Importer.
+ */
+class Exporter {
+public:
+  /**
+   * @brief exports the model (variables and factors) into a binary file
+   * @param the model to export
+   * @param the file to generate
+   */
+  template <typename Model>
+  static void exportToFile(const Model &model,
+                           const std::filesystem::path &file_path) {
+    convert(file_path, castToGetters(model));
+  }
+
+private:
+  static void convert(const std::filesystem::path &file_path,
+                      Getters subject);
+};
+} // namespace EFG::io::bin
@@ -0,0 +1,44 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#pragma once
+
+#include <EasyFactorGraph/io/ModelComponents.h>
+#include <EasyFactorGraph/misc/Cast.h>
+#include <EasyFactorGraph/structure/EvidenceManager.h>
+
+#include <filesystem>
+
+namespace EFG::io::bin {
+class Importer {
+public:
+  /**
+   * @brief parse the model (variables and factors) stored in a file generated
+   * by bin::Exporter and tries to add its factors to the passed model.
+   * The file is memory mapped and the images of the imported factors alias
+   * the mapping, instead of being copied: the mapping is released when the
+   * last of such factors is destroyed.
+   * @param recipient of the model parsed from file
+   * @param location of the model to parse and add to the passed one
+   * @throw in case the file is not a valid binary model or was generated by a
+   * different version of the exporter
+   */
+  template <typename Model>
+  static void importFromFile(Model &model,
+                             const std::filesystem::path &file_path) {
+    auto evidences = convert(castToInserters(model), file_path);
+    castAndUse<strct::EvidenceSetter>(
+        model, [&evidences](strct::EvidenceSetter &as_setter) {
+          as_setter.setEvidences(evidences);
+        });
+  }
+
+private:
+  static std::unordered_map<std::string, std::size_t>
+  convert(Inserters recipient, const std::filesystem::path &file_path);
+};
+} // namespace EFG::io::bin
@@ -0,0 +1,100 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#pragma once
+
+#include <EasyFactorGraph/categoric/Group.h>
+#include <EasyFactorGraph/trainable/TrainSet.h>
+#include <EasyFactorGraph/trainable/TrainSetSource.h>
+
+#include <filesystem>
+#include <fstream>
+
+namespace EFG::io::bin {
+/**
+ * @brief Exports a train set in a versioned binary format, made of:
+ * - an header, with the version, the number of variables and rows and the
+ * number of bytes used to store every value
+ * - a table of variables (sizes and names), describing the columns
+ * - the rows, packed one after the other in the same layout used by
+ * categoric::CombinationMatrix
+ *
+ * All the values are stored using the endianess of the machine generating the
+ * file.
+ * @param the file to generate
+ * @param the variables the values in every combination refer to
+ * @param the combinations to export. Repetitions are not accounted: compacted
+ * train sets should be exported after expanding them.
+ * @throw if the number of variables is not the size of the combinations
+ * @throw if some values exceed the sizes of the corresponding variables
+ */
+void export_train_set(const std::filesystem::path &file_path,
+                      const categoric::VariablesSoup &variables,
+                      const categoric::CombinationMatrix &combinations);
+
+struct TrainSetFile {
+  categoric::VariablesSoup variables;
+  train::TrainSet train_set;
+};
+/**
+ * @brief Imports a train set stored by export_train_set.
+ * The file is memory mapped and the rows are iterated straight from the
+ * mapping, instead of being copied: the mapping is released when the last
+ * object referring to it is destroyed.
+ * Values are not validated against the sizes of the variables.
+ * @throw in case the file is not a valid binary train set or was generated by
+ * a different version of the exporter
+ */
+TrainSetFile import_train_set(const std::filesystem::path &file_path);
+
+/**
+ * @brief Converts a train set stored in the text format accepted by
+ * io::import_train_set into the binary format generated by export_train_set.
+ * @param the text file to convert
+ * @param the variables the values in every row of the text file refer to
+ * @param the binary file to generate
+ */
+void convert_train_set(const std::filesystem::path &text_file_path,
+                       const categoric::VariablesSoup &variables,
+                       const std::filesystem::path &file_path);
+
+/**
+ * @brief A source reading the rows of a file generated by export_train_set,
+ * one chunk at a time. Differently from import_train_set, the file is not
+ * memory mapped: only the chunk currently returned is stored in memory.
+ */
+class TrainSetFileSource : public train::TrainSetSource {
+public:
+  /**
+   * @param the file to read
+   * @param the maximum number of rows in every chunk
+   * @throw in case the file is not a valid binary train set or was generated
+   * by a different version of the exporter
+   * @throw if the chunk size is 0
+   */
+  TrainSetFileSource(const std::filesystem::path &file_path,
+                     std::size_t chunk_rows);
+
+  /**
+   * @return the variables the values in every combination refer to
+   */
+  const categoric::VariablesSoup &getVariables() const { return variables; }
+
+  std::optional<categoric::CombinationMatrix> nextChunk() override;
+
+  void rewind() override;
+
+private:
+  std::ifstream stream;
+  categoric::VariablesSoup variables;
+  const std::size_t chunk_rows;
+  std::size_t width;
+  std::size_t rows;
+  std::streamoff rows_offset;
+  std::size_t next_row = 0;
+};
+} // namespace EFG::io::bin
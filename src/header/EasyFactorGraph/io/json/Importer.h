@@ -22,15 +22,23 @@ class Importer {
 public:
   /**
    * @brief imports the structure (variables and factors) described in
-   an xml file and add it to the passed model
+   a json file and add it to the passed model.
+   * The file is parsed as a stream, without building the entire json in
+   memory: variables and factors are created as soon as they are parsed.
+   * When the variables are described before the potentials and a single
+   thread is used, the memory used by the parser is proportional to the
+   biggest factor to import.
    * @param the model receiving the parsed data
-   * @param the path storing the xml to import
+   * @param the path storing the json to import
+   * @param the number of threads used to build the factors. When more than 1,
+   all the potentials are parsed before building them concurrently.
    */
   template <typename Model>
   static void importFromFile(Model &model,
-                             const std::filesystem::path &file_path) {
-    auto asJson = importJsonFromFile(file_path);
-    importFromJson(model, asJson);
+                             const std::filesystem::path &file_path,
+                             std::size_t threads = 1) {
+    auto evidences = convert(castToInserters(model), file_path, threads);
+    set_evidences(model, evidences);
   }
 
   /**
@@ -38,19 +46,23 @@ public:
    * json and tries to add its factors to the passed model.
    * @param recipient of the model parsed from file
    * @param json describing the model to parse and add to the passed one
+   * @param the number of threads used to build the factors
    */
   template <typename Model>
-  static void importFromJson(Model &model, const nlohmann::json &source) {
-    auto evidences = convert(castToInserters(model), source);
+  static void importFromJson(Model &model, const nlohmann::json &source,
+                             std::size_t threads = 1) {
+    auto evidences = convert(castToInserters(model), source, threads);
     set_evidences(model, evidences);
   }
 
 private:
   static std::unordered_map<std::string, std::size_t>
-  convert(Inserters recipient, const nlohmann::json &source);
+  convert(Inserters recipient, const nlohmann::json &source,
+          std::size_t threads);
 
-  static nlohmann::json
-  importJsonFromFile(const std::filesystem::path &file_path);
+  static std::unordered_map<std::string, std::size_t>
+  convert(Inserters recipient, const std::filesystem::path &file_path,
+          std::size_t threads);
 
   template <typename Model>
   static void
@@ -58,9 +70,7 @@ private:
                 const std::unordered_map<std::string, std::size_t> &ev) {
     castAndUse<strct::EvidenceSetter>(
         model, [&ev](strct::EvidenceSetter &as_setter) {
-          for (const auto &[var, val] : ev) {
-            as_setter.setEvidence(as_setter.findVariable(var), val);
-          }
+          as_setter.setEvidences(ev);
         });
   }
 };
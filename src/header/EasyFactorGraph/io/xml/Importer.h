@@ -23,22 +23,23 @@ public:
    * file and tries to add its factors to the passed model.
    * @param recipient of the model parsed from file
    * @param location of the model to parse and add to the passed one
+   * @param the number of threads used to build the factors
    */
   template <typename Model>
   static void importFromFile(Model &model,
-                             const std::filesystem::path &file_path) {
-    auto evidences = convert(castToInserters(model), file_path);
+                             const std::filesystem::path &file_path,
+                             std::size_t threads = 1) {
+    auto evidences = convert(castToInserters(model), file_path, threads);
     castAndUse<strct::EvidenceSetter>(
         model, [&evidences](strct::EvidenceSetter &as_setter) {
-          for (const auto &[var, val] : evidences) {
-            as_setter.setEvidence(as_setter.findVariable(var), val);
-          }
+          as_setter.setEvidences(evidences);
         });
   }
 
 private:
   static std::unordered_map<std::string, std::size_t>
-  convert(Inserters recipient, const std::filesystem::path &file_path);
+  convert(Inserters recipient, const std::filesystem::path &file_path,
+          std::size_t threads);
 };
 } // namespace EFG::io::xml
 #endif
@@ -23,7 +23,7 @@ template <typename T> struct Hasher {
 template <typename T> struct Comparator {
   bool operator()(const std::shared_ptr<T> &a,
                   const std::shared_ptr<T> &b) const {
-    return *a == *b;
+    return (a.get() == b.get()) || (*a == *b);
   }
 };
 } // namespace EFG
@@ -0,0 +1,33 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#pragma once
+
+#include <cstddef>
+
+namespace EFG {
+/**
+ * @brief A non owning view of contiguous elements.
+ */
+template <typename T> class Span {
+public:
+  Span(T *data, std::size_t size) : data_{data}, size_{size} {}
+
+  T *data() const { return data_; }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  T &operator[](std::size_t pos) const { return data_[pos]; }
+
+  T *begin() const { return data_; }
+  T *end() const { return data_ + size_; }
+
+private:
+  T *data_;
+  std::size_t size_;
+};
+} // namespace EFG
@@ -66,7 +66,7 @@ public:
    * samples generation
    * @param the number of threads to use for speeding up the process
    */
-  std::vector<std::vector<std::size_t>>
+  categoric::CombinationMatrix
   makeTrainSet(const GibbsSampler::SamplesGenerationContext &context,
                float range_percentage = 1.f, std::size_t threads = 1);
 
@@ -84,6 +84,32 @@ private:
   void replaceIfNeeded(train::TunerPtr &container,
                        const train::BaseTuner &subject);
 
+  // the evidences, with their positions in the train set combinations
+  using EvidencesPositions =
+      std::vector<std::pair<categoric::VariablePtr, std::size_t>>;
+
+  // the samples of a train set having the same evidence values
+  struct EvidencesBucket {
+    // same order of the EvidencesPositions used to build the bucket
+    std::vector<std::size_t> values;
+    std::size_t samples;
+  };
+
+  /**
+   * @brief adds to the passed betas the contributions of the buckets in
+   * [begin, end), processed one after the other.
+   */
+  void accumulateBetas(const EvidencesPositions &evidences_positions,
+                       const std::vector<EvidencesBucket> &buckets,
+                       std::size_t begin, std::size_t end, float coeff,
+                       std::vector<float> &betas);
+
   const std::vector<std::size_t> evidence_vars_positions;
+
+  // Copies of this model sharing the same factors, each with its own evidences
+  // and messages. Used to process the samples in parallel when computing the
+  // gradient. Built the first time they are needed, while weights and
+  // propagation settings are synced before every use.
+  std::vector<std::unique_ptr<ConditionalRandomField>> replicas;
 };
 } // namespace EFG::model
@@ -46,5 +46,15 @@ public:
 protected:
   std::vector<float> getWeightsGradient_(
       const train::TrainSet::Iterator &train_set_combinations) final;
+
+  std::vector<float> getWeightsGradientFromSource_(
+      train::TrainSetSource &train_set_source) final;
+
+private:
+  /**
+   * @brief propagates the belief with no evidences, which is required to
+   * compute the beta part of the gradient.
+   */
+  void prepareBetas();
 };
 } // namespace EFG::model
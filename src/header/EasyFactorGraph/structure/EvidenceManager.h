@@ -29,6 +29,26 @@ public:
    * std::size_t) , but passing the variable name, which is interally searched.
    */
   void setEvidence(const std::string &variable, std::size_t value);
+
+  /**
+   * @brief update the evidence set with many new evidences at once.
+   * The result is the same obtained calling setEvidence for each passed
+   * evidence, but the clusters of hidden variables and the messages
+   * representing the evidences are updated only once. In case all the passed
+   * variables are already part of the evidence set, only the evidence values
+   * are updated and the clusters of hidden variables are left untouched.
+   * @param the variables to put in the evidence set, with the evidence values
+   * @throw in case one of the passed variable is not part of the model.
+   * @throw in case one of the passed values is invalid. When throwing, the
+   * evidence set is left unchanged.
+   */
+  void setEvidences(const Evidences &evidences);
+
+  /**
+   * @brief similar to setEvidences(const Evidences &), but passing the
+   * variable names, which are internally searched.
+   */
+  void setEvidences(const std::unordered_map<std::string, std::size_t> &ev);
 };
 
 class EvidenceRemover : virtual public StateAware, virtual public BeliefAware {
@@ -33,6 +33,14 @@ public:
    */
   void copyConstFactor(const factor::Immutable &factor);
 
+  /**
+   * @brief add shallow copies of all the passed const factors to this model.
+   * Much faster than calling addConstFactor for each factor, as the
+   * structure of the model is updated only once.
+   * @throw if any of the factors can't be added: in such case none is added.
+   */
+  void addConstFactors(const std::vector<factor::ImmutablePtr> &factors);
+
   /**
    * @brief adds a collection of const factors ot this model.
    * Passing copy = true, deep copies are created and inserted in this model.
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <EasyFactorGraph/categoric/CombinationMatrix.h>
 #include <EasyFactorGraph/structure/bases/BeliefAware.h>
 #include <EasyFactorGraph/structure/bases/PoolAware.h>
 
@@ -61,6 +62,7 @@ public:
    * @brief Use Gibbs sampling approach to draw empirical samples. Values inside
    * the returned combiantion are ordered with the same order used for the
    * variables returned by getAllVariables().
+   * Samples are the rows of the returned matrix.
    *
    * In case some evidences are set, their values will appear as is in the
    * sampled combinations.
@@ -68,7 +70,7 @@ public:
    * @param number parameters for the samples generation
    * @param number of threads to use for the samples generation
    */
-  std::vector<std::vector<std::size_t>>
+  categoric::CombinationMatrix
   makeSamples(const SamplesGenerationContext &context, std::size_t threads = 1);
 
   struct SamplerNode {
@@ -95,6 +95,7 @@ private:
   std::vector<float> getMarginalDistribution(const NodeLocation &location);
 
   template <PropagationKind Kind> void checkPropagation_(std::size_t threads) {
+    refreshBelief();
     if (wouldNeedPropagation(Kind)) {
       ScopedPoolActivator activator(*this, threads);
       propagateBelief(Kind);
@@ -44,6 +44,19 @@ class Evidence : public UnaryFactor {
 public:
   Evidence(const Immutable &binary_factor,
            const categoric::VariablePtr &evidence_var, std::size_t evidence);
+
+  /**
+   * @brief builds the Evidence factors for all the values the evidence
+   * variable can assume, scanning the binary factor only once.
+   * @return the Evidence factors, the one at position k refers to the
+   * evidence value k
+   */
+  static std::vector<std::shared_ptr<const Evidence>>
+  makeSlices(const Immutable &binary_factor,
+             const categoric::VariablePtr &evidence_var);
+
+private:
+  Evidence(const categoric::VariablePtr &hidden_var, std::vector<float> images);
 };
 
 class Indicator : public UnaryFactor {
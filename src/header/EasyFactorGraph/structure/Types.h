@@ -26,7 +26,22 @@ struct Node {
     factor::ImmutablePtr factor;
     // incoming message
     // nullptr when the message is not already available
-    std::unique_ptr<const factor::UnaryFactor> message;
+    std::shared_ptr<const factor::UnaryFactor> message;
+
+    // the messages to use when the sender is an evidence, one for each
+    // evidence value. Built the first time they are needed and shared by the
+    // message, so that changing the evidence value does not recompute
+    // anything.
+    std::vector<std::shared_ptr<const factor::Evidence>> evidence_slices;
+
+    /**
+     * @brief sets the incoming message to the one representing the
+     * marginalization of the sender, assumed to be an evidence.
+     * @param the sender variable
+     * @param the evidence value of the sender
+     */
+    void setEvidenceMessage(const categoric::VariablePtr &sender,
+                            std::size_t evidence);
   };
 
   std::unordered_map<Node *, Connection> active_connections;
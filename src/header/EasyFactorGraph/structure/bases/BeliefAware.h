@@ -14,6 +14,12 @@
 
 namespace EFG::strct {
 
+/**
+ * @brief The same strategy can be shared by copies of a model propagating the
+ * belief at the same time, like the replicas of a ConditionalRandomField
+ * computing the gradient with many threads. Hence, propagateBelief should not
+ * modify any state of the strategy itself.
+ */
 class LoopyBeliefPropagationStrategy {
 public:
   virtual ~LoopyBeliefPropagationStrategy() = default;
@@ -49,6 +55,20 @@ protected:
   BeliefAware();
 
   void resetBelief() { lastPropagation.reset(); }
+
+  /**
+   * @brief called before checking whether a propagation is needed. Allows
+   * derived classes to reset the belief when something it depends on was
+   * changed from outside this object.
+   */
+  virtual void refreshBelief() {}
+
+  /**
+   * @brief uses the same propagation context and loopy propagation strategy
+   * of the passed object. The strategy is shared, not copied.
+   */
+  void sharePropagationSettings(const BeliefAware &o);
+
   bool wouldNeedPropagation(PropagationKind kind) const;
   void propagateBelief(PropagationKind kind);
 
@@ -61,6 +81,6 @@ private:
    */
   std::optional<PropagationResult> lastPropagation;
 
-  LoopyBeliefPropagationStrategyPtr loopy_propagator;
+  std::shared_ptr<LoopyBeliefPropagationStrategy> loopy_propagator;
 };
 } // namespace EFG::strct
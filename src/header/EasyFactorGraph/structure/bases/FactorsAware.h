@@ -21,9 +21,23 @@ public:
 protected:
   void addDistribution(const EFG::factor::ImmutablePtr &distribution);
 
+  /**
+   * @brief Adds many distributions at once. All the distributions are
+   * validated before modifying the model: in case any of them can't be
+   * added, none is added. Differently from calling addDistribution for each
+   * distribution, the clusters of hidden variables are recomputed only once,
+   * after having linked all the distributions.
+   * @throw if any of the distributions can't be added
+   */
+  void addDistributions(
+      const std::vector<EFG::factor::ImmutablePtr> &distributions);
+
 private:
   NodeLocation findOrMakeNode(const categoric::VariablePtr &var);
 
+  void checkDistributions(
+      const std::vector<EFG::factor::ImmutablePtr> &distributions) const;
+
   void addUnaryDistribution(const EFG::factor::ImmutablePtr &unary_factor);
 
   void addBinaryDistribution(const EFG::factor::ImmutablePtr &binary_factor);
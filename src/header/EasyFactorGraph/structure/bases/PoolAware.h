@@ -40,9 +40,11 @@ private:
   struct Worker {
     Worker(std::size_t th_id, Context &context);
 
-    std::thread loop;
-
+    // declared before loop, as it must be initialized before starting the
+    // thread reading it
     std::atomic<const Tasks *> to_process = nullptr;
+
+    std::thread loop;
   };
   using WorkerPtr = std::unique_ptr<Worker>;
   std::vector<WorkerPtr> workers;
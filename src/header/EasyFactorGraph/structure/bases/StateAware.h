@@ -10,6 +10,8 @@
 #include <EasyFactorGraph/structure/SpecialFactors.h>
 #include <EasyFactorGraph/structure/Types.h>
 
+#include <string_view>
+
 namespace EFG::strct {
 
 class StateAware {
@@ -55,6 +57,9 @@ protected:
 
   struct GraphState {
     categoric::VariablesSoup variables;
+    // index of the above variables, by name
+    std::unordered_map<std::string_view, categoric::VariablePtr>
+        variables_by_name;
     Nodes nodes;
     HiddenClusters clusters;
     Evidences evidences;
@@ -7,7 +7,9 @@
 
 #pragma once
 
+#include <EasyFactorGraph/misc/Span.h>
 #include <EasyFactorGraph/structure/bases/FactorsAware.h>
+#include <EasyFactorGraph/trainable/TrainSetSource.h>
 #include <EasyFactorGraph/trainable/tuners/Tuner.h>
 
 #include <optional>
@@ -41,10 +43,42 @@ public:
    * @return sets the weights to use for of all the tunable factors that are
    * part of the model. The same order assumed by getTunableClusters() should be
    * assumed.
+   * Only the cached quantities depending on the weights actually changed are
+   * invalidated.
    * @throw in case the number of specified weights is inconsistent
    */
   void setWeights(const std::vector<float> &weights);
 
+  /**
+   * @return a view of the weights returned by getWeights(), not copying them.
+   * The weights of all the tunable factors are stored in a single buffer
+   * owned by the model, unless the tunable factors were absorbed from many
+   * other models (refer to FactorsTunableInserter::addTunableFactor): in such
+   * case they might be scattered and a nullopt is returned.
+   */
+  std::optional<Span<const float>> getWeightsSpan() const;
+
+  /**
+   * @brief allows to update in place the weights, without copying them.
+   * After calling the predicate, the cached quantities depending on the
+   * changed weights are invalidated, as done by setWeights.
+   * Pred(Span<float> weights)
+   * @return false in case the weights are not stored contiguously (refer to
+   * getWeightsSpan()), without calling the predicate.
+   */
+  template <typename Pred> bool updateWeights(Pred &&pred) {
+    auto span = getWeightsSpan();
+    if (!span.has_value()) {
+      return false;
+    }
+    pred(Span<float>{const_cast<float *>(span->data()), span->size()});
+    if (!weights_slots.empty()) {
+      weights_slots.front().buffer->markChanged();
+    }
+    weightsUpdated();
+    return true;
+  }
+
   /**
    * @return the gradients of the weights of all the tunable factors that are
    * part of the model, w.r.t a certain training set. The same order assumed by
@@ -56,14 +90,95 @@ public:
   getWeightsGradient(const TrainSet::Iterator &train_set_combinations,
                      std::size_t threads = 1);
 
+  /**
+   * @brief similar to getWeightsGradient(const TrainSet::Iterator &,
+   * std::size_t), with the difference that the training set is consumed one
+   * chunk at a time: only the chunk currently processed needs to be stored in
+   * memory. The source is rewound after all its chunks were consumed.
+   * @param the source of the training set to use
+   * @param the number of threads to use for the gradient computation
+   * @throw if the source provides no combinations
+   */
+  std::vector<float> getWeightsGradient(TrainSetSource &train_set_source,
+                                        std::size_t threads = 1);
+
+  /**
+   * @return the gradients of the pseudo-likelihood of a certain training set
+   * w.r.t. the weights of all the tunable factors, refer to
+   * https://en.wikipedia.org/wiki/Pseudolikelihood.
+   * For every sample, each variable not set as evidence is predicted from the
+   * values its neighbours assume in the sample: the belief is never
+   * propagated, making the computation much cheaper than the one of
+   * getWeightsGradient, especially for loopy models.
+   * The same order assumed by getTunableClusters() is assumed.
+   * @param the training set to use
+   * @param the number of threads to use for the gradient computation
+   */
+  std::vector<float>
+  getPseudoLikelihoodGradient(const TrainSet::Iterator &train_set_combinations,
+                              std::size_t threads = 1);
+
+  /**
+   * @brief similar to getPseudoLikelihoodGradient(const TrainSet::Iterator &,
+   * std::size_t), consuming the training set one chunk at a time.
+   * @param the source of the training set to use
+   * @param the number of threads to use for the gradient computation
+   * @throw if the source provides no combinations
+   */
+  std::vector<float>
+  getPseudoLikelihoodGradient(TrainSetSource &train_set_source,
+                              std::size_t threads = 1);
+
   class ModelWrapper;
 
 protected:
   virtual std::vector<float>
   getWeightsGradient_(const TrainSet::Iterator &train_set_combinations) = 0;
 
+  /**
+   * @brief the default implementation computes the gradient of every chunk
+   * and returns their average, weighted by the number of samples in every
+   * chunk.
+   */
+  virtual std::vector<float>
+  getWeightsGradientFromSource_(TrainSetSource &train_set_source);
+
+  std::vector<float> getPseudoLikelihoodGradient_(
+      const TrainSet::Iterator &train_set_combinations);
+
+  std::vector<float>
+  getPseudoLikelihoodGradientFromSource_(TrainSetSource &train_set_source);
+
   std::unordered_set<FactorExponentialPtr> tunable_factors;
   Tuners tuners;
+
+  // buffer storing the weights of the tunable factors added to this model
+  factor::WeightsBufferPtr weights_buffer =
+      std::make_shared<factor::WeightsBuffer>();
+  // where the weight of every tuner is stored
+  std::vector<factor::WeightSlot> weights_slots;
+  // the weights assumed by the cached quantities, like the merged unaries
+  std::vector<float> weights_snapshot;
+  // the buffers storing the weights, with the version assumed by the cached
+  // quantities
+  std::vector<std::pair<factor::WeightsBufferPtr, std::size_t>>
+      buffers_versions;
+
+  // keeps track of the changes done to the passed buffer
+  void trackBuffer(const factor::WeightsBufferPtr &buffer);
+
+  // invalidates the cached quantities depending on the weight of the passed
+  // factor
+  void invalidateCaches(const factor::FactorExponential &factor);
+
+  // the weights may have been changed by other models sharing the same
+  // buffers
+  void refreshBelief() override;
+
+private:
+  // invalidates the cached quantities depending on the weights changed since
+  // the last time this function was called
+  void weightsUpdated();
 };
 
 class FactorsTunableInserter : virtual public FactorsTunableGetter {
@@ -71,15 +186,39 @@ public:
   /**
    * @brief add a shallow copy of the passed tunable expoenential factor to this
    * model.
+   * The weight of the factor is bound to a position in the weights buffer of
+   * this model. When the factor was already bound by another model, like
+   * when shallow copying a whole model, the binding is kept and the
+   * buffer is shared with the other model: changing the weight from one model
+   * affects also the other one.
    * @param the factor to insert
    * @param an optional group of variables specifying the tunable factor that
    * should share the weight with the one to insert. When passing a nullopt the
    * factor will be inserted without sharing its weight.
+   * @throw if the factor is already bound to a weight different from the one
+   * it should share
    */
   void addTunableFactor(const FactorExponentialPtr &factor,
                         const std::optional<categoric::VariablesSet>
                             &group_sharing_weight = std::nullopt);
 
+  struct TunableFactorToAdd {
+    FactorExponentialPtr factor;
+    std::optional<categoric::VariablesSet> group_sharing_weight = std::nullopt;
+  };
+  /**
+   * @brief add shallow copies of all the passed tunable expoenential factors to
+   * this model. Much faster than calling addTunableFactor for each factor, as
+   * the structure of the model is updated only once.
+   * @param the factors to insert, each with the optional group of variables
+   * specifying the tunable factor that should share the weight with it. Such
+   * factor can also be one of the ones to insert, as long as it comes before.
+   * @throw if any of the factors can't be added to the structure, or if any
+   * group sharing the weight refers to an unknown factor: in such case none is
+   * added.
+   */
+  void addTunableFactors(const std::vector<TunableFactorToAdd> &factors);
+
   /**
    * @brief add a deep copy of the passed tunable expoenential factor to this
    * model.
@@ -126,8 +265,24 @@ public:
 protected:
   Tuners::iterator findTuner(const categoric::VariablesSet &tuned_vars_group);
 
+  // throws if the group sharing the weight of any of the passed factors
+  // refers neither to an already tuned factor, nor to a previous factor of the
+  // same batch. Throws also when a factor whose weight is already bound (by
+  // another model) should share the weight of a cluster bound to a different
+  // slot: the factor would be otherwise driven by 2 models at the same time.
+  void checkSharingGroups(const std::vector<TunableFactorToAdd> &factors);
+
 private:
-  TunerPtr makeTuner(const FactorExponentialPtr &factor);
+  TunerPtr makeTuner(const FactorExponentialPtr &factor,
+                     const categoric::VariablesSoup &vars);
+
+  void
+  addTuner(const FactorExponentialPtr &factor,
+           const std::optional<categoric::VariablesSet> &group_sharing_weight,
+           const categoric::VariablesSoup &vars);
+
+  // binds the weight of a factor not sharing the weight with other tuners
+  factor::WeightSlot bindWeight(factor::FactorExponential &factor);
 };
 
 /**
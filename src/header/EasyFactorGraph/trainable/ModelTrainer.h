@@ -5,14 +5,23 @@
  * report any bug to andrecasa91@gmail.com.
  **/
 
-#ifdef EFG_LEARNING_ENABLED
-
 #pragma once
 
 #include <EasyFactorGraph/trainable/FactorsTunableManager.h>
+#include <EasyFactorGraph/trainable/Optimizers.h>
+
+#ifdef EFG_LEARNING_ENABLED
 #include <TrainingTools/Trainer.h>
+#endif
 
 namespace EFG::train {
+enum class TrainObjective {
+  // refer to FactorsTunableGetter::getWeightsGradient
+  LIKELIHOOD,
+  // refer to FactorsTunableGetter::getPseudoLikelihoodGradient
+  PSEUDO_LIKELIHOOD
+};
+
 struct TrainInfo {
   /**
    * @brief Number of threads to use for the training procedure.
@@ -24,8 +33,46 @@ struct TrainInfo {
    * based approach.
    */
   float stochastic_percentage = 1.f;
+  /**
+   * @brief The seed used to shuffle the samples at every epoch, when
+   * adopting a stochastic gradient based approach. Passing a nullopt, a random
+   * seed is used.
+   */
+  std::optional<std::size_t> seed;
+  /**
+   * @brief The objective to maximize. The pseudo-likelihood doesn't require
+   * to propagate the belief, making the training of big loopy models much
+   * faster.
+   */
+  TrainObjective objective = TrainObjective::LIKELIHOOD;
 };
 
+/**
+ * @brief tunes the model with one of the natively provided optimizers,
+ * updating the weights at every iteration.
+ * @param the model to tune
+ * @param the optimizer to use
+ * @param the train set to use
+ */
+void train_model(FactorsTunableGetter &subject, Optimizer &optimizer,
+                 const TrainSet &train_set,
+                 const TrainInfo &info = TrainInfo{});
+
+/**
+ * @brief similar to train_model(FactorsTunableGetter &, Optimizer &,
+ * const TrainSet &, const TrainInfo &), consuming the train set one chunk at a
+ * time at every gradient computation. TrainInfo::stochastic_percentage is
+ * ignored.
+ * @param the model to tune
+ * @param the optimizer to use
+ * @param the source of the train set to use
+ */
+void train_model(FactorsTunableGetter &subject, Optimizer &optimizer,
+                 TrainSetSource &train_set_source,
+                 const TrainInfo &info = TrainInfo{});
+
+#ifdef EFG_LEARNING_ENABLED
+
 /**
  * @param the model to tune
  * @param the training approach to adopt
@@ -35,6 +82,17 @@ void train_model(FactorsTunableGetter &subject, ::train::Trainer &trainer,
                  const TrainSet &train_set,
                  const TrainInfo &info = TrainInfo{});
 
-} // namespace EFG::train
-
+/**
+ * @brief similar to train_model(FactorsTunableGetter &, ::train::Trainer &,
+ * const TrainSet &, const TrainInfo &), consuming the train set one chunk at a
+ * time at every gradient computation. TrainInfo::stochastic_percentage is
+ * ignored.
+ * @param the model to tune
+ * @param the training approach to adopt
+ * @param the source of the train set to use
+ */
+void train_model(FactorsTunableGetter &subject, ::train::Trainer &trainer,
+                 TrainSetSource &train_set_source,
+                 const TrainInfo &info = TrainInfo{});
 #endif
+} // namespace EFG::train
@@ -0,0 +1,159 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#pragma once
+
+#include <EasyFactorGraph/misc/Span.h>
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+namespace EFG::train {
+/**
+ * @brief Gradient based optimizer updating in place the weights of a model,
+ * in order to maximize the likelihood of a train set.
+ * Differently from the trainers of TrainingTools, the weights and the
+ * gradients are exchanged as they are, without any conversion.
+ */
+class Optimizer {
+public:
+  virtual ~Optimizer() = default;
+
+  /**
+   * @brief sets the maximum number of updates done in a single training.
+   * @throw if the passed value is 0
+   */
+  void setMaxIterations(std::size_t iterations);
+  std::size_t getMaxIterations() const { return max_iterations; }
+
+  /**
+   * @brief the training stops as soon as all the components of the gradient
+   * are below, in absolute value, the passed tolerance.
+   * @throw if the passed value is negative
+   */
+  void setTolerance(float tolerance);
+  float getTolerance() const { return tolerance; }
+
+  /**
+   * @brief forgets the state accumulated by the previous updates. Called at
+   * the beginning of every training.
+   * @param the number of weights to optimize
+   */
+  virtual void reset(std::size_t size) = 0;
+
+  /**
+   * @brief updates in place the weights.
+   * @param the weights to update, usually the buffer of the trained model
+   * (refer to FactorsTunableGetter::updateWeights)
+   * @param the gradient of the likelihood w.r.t. the weights, i.e. the
+   * direction of steepest ascent
+   * @throw if the sizes of the weights and the gradient are not the ones
+   * passed to reset
+   */
+  virtual void step(Span<float> weights, Span<const float> gradient) = 0;
+
+private:
+  std::size_t max_iterations = 100;
+  float tolerance = 1e-3f;
+};
+
+/**
+ * @brief Gradient ascent, with an optional momentum:
+ * v = momentum * v + learning_rate * gradient
+ * w = w + v
+ */
+class SGD : public Optimizer {
+public:
+  /**
+   * @throw if the learning rate is not positive
+   * @throw if the momentum is not in [0, 1)
+   */
+  SGD(float learning_rate, float momentum = 0);
+
+  void reset(std::size_t size) override;
+
+  void step(Span<float> weights, Span<const float> gradient) override;
+
+private:
+  const float learning_rate;
+  const float momentum;
+  std::vector<float> velocity;
+};
+
+/**
+ * @brief Refer to https://arxiv.org/abs/1412.6980
+ */
+class Adam : public Optimizer {
+public:
+  /**
+   * @throw if the learning rate or epsilon are not positive
+   * @throw if the decay rates are not in [0, 1)
+   */
+  Adam(float learning_rate = 0.1f, float beta1 = 0.9f, float beta2 = 0.999f,
+       float epsilon = 1e-8f);
+
+  void reset(std::size_t size) override;
+
+  void step(Span<float> weights, Span<const float> gradient) override;
+
+private:
+  const float learning_rate;
+  const float beta1;
+  const float beta2;
+  const float epsilon;
+  // first and second moments estimates
+  std::vector<float> first_moments;
+  std::vector<float> second_moments;
+  // beta1 and beta2 to the power of the number of done steps
+  float beta1_power;
+  float beta2_power;
+};
+
+/**
+ * @brief Limited memory BFGS, refer to
+ * https://en.wikipedia.org/wiki/Limited-memory_BFGS
+ *
+ * No line search is performed, as the likelihood is not evaluated: the
+ * direction obtained by the two loops recursion is scaled by the learning rate
+ * and, when the curvature is not positive, the history is dropped and a
+ * gradient ascent step is done.
+ * Should be used with the entire train set, i.e. without stochasticity.
+ */
+class LBFGS : public Optimizer {
+public:
+  /**
+   * @param the number of past updates used to approximate the hessian
+   * @param the learning rate
+   * @param the maximum norm of a single update
+   * @throw if the memory is 0
+   * @throw if the learning rate or the maximum step are not positive
+   */
+  LBFGS(std::size_t memory = 10, float learning_rate = 1.f,
+        float max_step = 5.f);
+
+  void reset(std::size_t size) override;
+
+  void step(Span<float> weights, Span<const float> gradient) override;
+
+private:
+  const std::size_t memory;
+  const float learning_rate;
+  const float max_step;
+
+  struct Correction {
+    // difference between consecutive weights
+    std::vector<float> s;
+    // difference between consecutive gradients of the negated likelihood
+    std::vector<float> y;
+    float rho;
+  };
+  std::deque<Correction> corrections;
+  std::vector<float> previous_weights;
+  std::vector<float> previous_gradient;
+};
+} // namespace EFG::train
@@ -7,32 +7,95 @@
 
 #pragma once
 
+#include <EasyFactorGraph/categoric/CombinationMatrix.h>
+
 #include <memory>
 #include <optional>
+#include <random>
 #include <vector>
 
 namespace EFG::train {
 
 using Combinations = std::vector<std::vector<std::size_t>>;
 
+/**
+ * @brief hashes combinations of any size, to store them in unordered
+ * containers.
+ */
+struct CombinationHasher {
+  std::size_t operator()(const std::vector<std::size_t> &comb) const {
+    std::size_t res = comb.size();
+    for (auto val : comb) {
+      res ^= val + 0x9e3779b9 + (res << 6) + (res >> 2);
+    }
+    return res;
+  }
+};
+
+/**
+ * @brief A set of combinations used to train a model. Combinations are stored
+ * in a categoric::CombinationMatrix.
+ */
 class TrainSet {
 public:
   /**
    * @param the set of combinations that will be part of the train set.
+   * @param when passing true, the combinations appearing many times are
+   * stored only once, together with the number of times they appear. The
+   * gradient computations then visit every distinct combination only once.
    * @throw if the combinations don't have all the same size
    * @throw if the combinations container is empty
    */
-  TrainSet(const std::vector<std::vector<std::size_t>> &combinations);
+  TrainSet(categoric::CombinationMatrix combinations, bool compact = false);
 
-  const auto &getCombinations() const { return *this->combinations; };
+  /**
+   * @param the distinct combinations that will be part of the train set.
+   * @param the number of times each combination appears in the train set.
+   * @throw if the combinations don't have all the same size
+   * @throw if the combinations container is empty
+   * @throw if the number of counts is not the number of combinations, or
+   * some counts are equal to 0
+   */
+  TrainSet(categoric::CombinationMatrix combinations,
+           const std::vector<std::size_t> &counts);
+
+  const categoric::CombinationMatrix &getCombinations() const {
+    return *this->combinations;
+  };
+
+  /**
+   * @return the number of times each combination of getCombinations()
+   * appears in the train set. Empty when every combination appears once.
+   */
+  const std::vector<std::size_t> &getCounts() const { return *this->counts; };
+
+  /**
+   * @return the number of samples, accounting also for the repeated ones.
+   */
+  std::size_t size() const { return samples; }
 
   class Iterator;
   Iterator makeIterator() const;
 
+  /**
+   * @brief the samples to visit are drawn without replacement, using an
+   * engine local to the calling thread. Prefer a MinibatchScheduler when
+   * many subsets should be visited one after the other.
+   * @param the percentage of samples to visit
+   */
   Iterator makeSubSetIterator(float percentage) const;
 
+  // cache of the empirical distributions computed by the iterators
+  struct Distributions;
+
 private:
-  std::shared_ptr<const Combinations> combinations;
+  friend class MinibatchScheduler;
+
+  std::shared_ptr<const categoric::CombinationMatrix> combinations;
+  std::shared_ptr<const std::vector<std::size_t>> counts;
+  std::size_t samples;
+  // shared by all the iterators visiting the entire train set
+  std::shared_ptr<Distributions> distributions;
 };
 
 /**
@@ -49,28 +112,176 @@ public:
    */
   Iterator(const TrainSet &subject, float percentage);
 
+  /**
+   * @brief visits all the distinct combinations, together with their weight,
+   * i.e. the number of samples equal to that combination.
+   * Predicate(const categoric::CombinationMatrix::Row &combination,
+   * std::size_t weight)
+   */
   template <typename Predicate>
   void forEachSample(const Predicate &pred) const {
-    if (combinations_subset.has_value()) {
-      const auto &coll = *combinations;
-      for (auto index : combinations_subset.value()) {
-        pred(coll[index]);
+    forEachSample(0, entries(), pred);
+  }
+
+  /**
+   * @brief similar to forEachSample(const Predicate &), but considering only
+   * the entries in the [begin, end) portion of the ones iterated by this
+   * object. Allows to split the samples among many workers.
+   */
+  template <typename Predicate>
+  void forEachSample(std::size_t begin, std::size_t end,
+                     const Predicate &pred) const {
+    const auto &coll = *combinations;
+    if (subset != nullptr) {
+      const auto &positions = *subset;
+      for (std::size_t k = begin; k < end; ++k) {
+        pred(coll[positions[subset_begin + k]], std::size_t{1});
+      }
+      return;
+    }
+    const auto &cnt = *counts;
+    if (cnt.empty()) {
+      for (std::size_t k = begin; k < end; ++k) {
+        pred(coll[k], std::size_t{1});
       }
       return;
     }
-    for (const auto &sample : *combinations) {
-      pred(sample);
+    for (std::size_t k = begin; k < end; ++k) {
+      pred(coll[k], cnt[k]);
     }
   }
 
   /**
-   * @return number of combinations considered by this train set iterator.
+   * @return number of samples considered by this train set iterator,
+   * accounting also for the repeated ones.
    */
   std::size_t size() const;
 
+  /**
+   * @return number of combinations visited by forEachSample.
+   */
+  std::size_t entries() const;
+
+  /**
+   * @brief computes the empirical distribution of a subset of variables, i.e.
+   * the frequencies of their values in the samples considered by this object.
+   * The distribution of every subset is computed only once. When iterating
+   * the entire train set, computed distributions are shared by all the
+   * iterators of the same TrainSet.
+   * @param the positions of the variables in the combinations
+   * @param the sizes of the variables
+   * @return the frequencies of all the combinations of the subset, ordered in
+   * the same way GroupRange iterates their joint domain
+   * @throw if some samples have values exceeding the passed sizes
+   */
+  const std::vector<float> &
+  getEmpiricalDistribution(const std::vector<std::size_t> &positions,
+                           const std::vector<std::size_t> &sizes) const;
+
+private:
+  friend class MinibatchScheduler;
+  /**
+   * @brief visits the combinations in the positions stored in
+   * [subset_begin, subset_end) of the passed subset.
+   */
+  Iterator(const TrainSet &subject,
+           std::shared_ptr<const std::vector<std::size_t>> subset,
+           std::size_t subset_begin, std::size_t subset_end);
+
+  std::shared_ptr<const categoric::CombinationMatrix> combinations;
+  std::shared_ptr<const std::vector<std::size_t>> counts;
+  std::size_t samples;
+  std::shared_ptr<Distributions> distributions;
+
+  // positions of the combinations to visit, when not visiting the entire
+  // train set
+  std::shared_ptr<const std::vector<std::size_t>> subset;
+  std::size_t subset_begin = 0;
+  std::size_t subset_end = 0;
+};
+
+/**
+ * @brief Draws the samples of a train set without replacement, returning the
+ * position of the combination of every drawn sample. The combinations
+ * appearing many times in a compacted train set are never expanded: their
+ * remaining counts are stored in a Fenwick tree, making every draw logarithmic
+ * in the number of distinct combinations.
+ */
+class SamplesUrn {
+public:
+  /**
+   * @brief the urn is initially empty (refer to refill).
+   * @param the number of distinct combinations
+   * @param the number of times each combination appears. When empty, every
+   * combination is assumed to appear once.
+   */
+  SamplesUrn(std::size_t combinations,
+             std::shared_ptr<const std::vector<std::size_t>> counts);
+
+  /**
+   * @brief puts back all the samples.
+   */
+  void refill();
+
+  std::size_t remaining() const { return remaining_; }
+
+  /**
+   * @return the position of the combination of the drawn sample
+   * @throw if the urn is empty
+   */
+  std::size_t draw(std::mt19937_64 &engine);
+
 private:
-  std::shared_ptr<const Combinations> combinations;
+  std::size_t combinations;
+  std::shared_ptr<const std::vector<std::size_t>> counts;
+  // 1-based Fenwick tree of the remaining counts
+  std::vector<std::size_t> tree;
+  std::size_t highest_step = 0;
+  std::size_t remaining_ = 0;
+};
 
-  std::optional<std::vector<std::size_t>> combinations_subset;
+/**
+ * @brief Splits the samples of a train set into minibatches, for stochastic
+ * gradient based approaches. The samples of every batch are drawn without
+ * replacement from the ones not yet visited in the current epoch: every sample
+ * is visited exactly once per epoch, as when shuffling all of them at the
+ * beginning of the epoch and splitting them into contiguous batches.
+ *
+ * The engine used to shuffle the samples is owned by this object, which can be
+ * then used concurrently to other schedulers.
+ */
+class MinibatchScheduler {
+public:
+  /**
+   * @param the train set to split
+   * @param the percentage of samples in every batch. The last batch of every
+   * epoch can be smaller.
+   * @param the seed of the engine used to shuffle the samples. Passing a
+   * nullopt, a random seed is used.
+   * @throw if the percentage is not in (0, 1]
+   */
+  MinibatchScheduler(const TrainSet &subject, float percentage,
+                     std::optional<std::size_t> seed = std::nullopt);
+
+  /**
+   * @return an iterator visiting the samples of the next batch. A new epoch
+   * is started when all the batches of the current one were returned.
+   */
+  TrainSet::Iterator next();
+
+  /**
+   * @return the number of started epochs
+   */
+  std::size_t getEpoch() const { return epoch; }
+
+  std::size_t getBatchSize() const { return batch_size; }
+
+private:
+  TrainSet subject;
+  std::size_t batch_size;
+  std::mt19937_64 engine;
+  // the samples not yet visited in the current epoch
+  SamplesUrn urn;
+  std::size_t epoch = 0;
 };
 } // namespace EFG::train
@@ -0,0 +1,120 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#pragma once
+
+#include <EasyFactorGraph/categoric/CombinationMatrix.h>
+
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+
+namespace EFG::train {
+/**
+ * @brief A train set made available one chunk of combinations at a time,
+ * instead of being entirely stored in memory. Chunks can be for instance read
+ * from a file or generated on the fly.
+ */
+class TrainSetSource {
+public:
+  virtual ~TrainSetSource() = default;
+
+  /**
+   * @return the next chunk of combinations, or a nullopt when all the chunks
+   * were already returned.
+   */
+  virtual std::optional<categoric::CombinationMatrix> nextChunk() = 0;
+
+  /**
+   * @brief restarts from the first chunk.
+   */
+  virtual void rewind() = 0;
+};
+
+/**
+ * @brief Rewinds a source when going out of scope, so that the next pass
+ * starts from the first chunk even when the current one was interrupted by an
+ * exception.
+ */
+class ScopedRewind {
+public:
+  ScopedRewind(TrainSetSource &source) : source{source} {}
+
+  ScopedRewind(const ScopedRewind &) = delete;
+  ScopedRewind &operator=(const ScopedRewind &) = delete;
+
+  ~ScopedRewind() noexcept(false) {
+    if (std::uncaught_exceptions() == exceptions) {
+      source.rewind();
+      return;
+    }
+    // already unwinding: the original exception is the one to propagate
+    try {
+      source.rewind();
+    } catch (...) {
+    }
+  }
+
+private:
+  TrainSetSource &source;
+  const int exceptions = std::uncaught_exceptions();
+};
+
+/**
+ * @brief A source whose chunks are produced by a generator, like a
+ * GibbsSampler drawing samples from a model.
+ */
+class GeneratedSource : public TrainSetSource {
+public:
+  // receives the index of the chunk to generate
+  using Generator = std::function<categoric::CombinationMatrix(std::size_t)>;
+
+  /**
+   * @param the generator of the chunks
+   * @param the number of chunks to generate before stopping
+   */
+  GeneratedSource(Generator generator, std::size_t chunks);
+
+  std::optional<categoric::CombinationMatrix> nextChunk() override;
+
+  void rewind() override { next_chunk = 0; }
+
+private:
+  const Generator generator;
+  const std::size_t chunks;
+  std::size_t next_chunk = 0;
+};
+
+/**
+ * @brief Wraps another source, retrieving the next chunk on a background
+ * thread while the current one is processed.
+ * At most 2 chunks are then alive at the same time.
+ *
+ * The wrapped source is accessed by the background thread: when it is a
+ * GeneratedSource, the generator should not use the model being trained.
+ */
+class ReadAheadSource : public TrainSetSource {
+public:
+  /**
+   * @throw if the passed source is null
+   */
+  ReadAheadSource(std::unique_ptr<TrainSetSource> source);
+  ~ReadAheadSource() override;
+
+  std::optional<categoric::CombinationMatrix> nextChunk() override;
+
+  void rewind() override;
+
+private:
+  void readAhead();
+
+  std::unique_ptr<TrainSetSource> source;
+  std::future<std::optional<categoric::CombinationMatrix>> next_chunk;
+};
+} // namespace EFG::train
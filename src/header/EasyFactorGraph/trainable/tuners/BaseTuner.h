@@ -7,7 +7,6 @@
 
 #pragma once
 
-#include <EasyFactorGraph/factor/ImageFinder.h>
 #include <EasyFactorGraph/trainable/tuners/Tuner.h>
 
 namespace EFG::train {
@@ -16,6 +15,12 @@ public:
   FactorExponentialPtr getFactorPtr() const { return factor; }
   const factor::FactorExponential &getFactor() const { return *factor; }
 
+  /**
+   * @brief computed from the empirical distribution of the variables of the
+   * factor, which is obtained from the passed iterator. The cost is therefore
+   * independent from the number of samples, once such distribution is
+   * available.
+   */
   float getGradientAlpha(const TrainSet::Iterator &iter) final;
   void setWeight(float w) final { factor->setWeight(w); }
   float getWeight() const final { return factor->getWeight(); };
@@ -29,11 +34,8 @@ protected:
 private:
   FactorExponentialPtr factor;
 
-  factor::ImageFinder finder;
-  struct GradientAlphaPart {
-    const TrainSet::Iterator *train_set_iterator;
-    float value;
-  };
-  std::optional<GradientAlphaPart> alpha_part;
+  // positions in the train set combinations of the variables of the factor
+  std::vector<std::size_t> positions_in_model;
+  std::vector<std::size_t> sizes;
 };
 } // namespace EFG::train
@@ -0,0 +1,158 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#include <EasyFactorGraph/Error.h>
+#include <EasyFactorGraph/categoric/CombinationMatrix.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+namespace EFG::categoric {
+namespace {
+std::size_t width_for(std::size_t max_value) {
+  if (max_value <= std::numeric_limits<std::uint8_t>::max()) {
+    return 1;
+  }
+  if (max_value <= std::numeric_limits<std::uint16_t>::max()) {
+    return 2;
+  }
+  if (max_value <= std::numeric_limits<std::uint32_t>::max()) {
+    return 4;
+  }
+  return 8;
+}
+
+template <typename T> void write(std::uint8_t *recipient, std::size_t value) {
+  const T casted = static_cast<T>(value);
+  std::memcpy(recipient, &casted, sizeof(T));
+}
+
+void write(std::uint8_t *recipient, std::size_t width, std::size_t value) {
+  switch (width) {
+  case 1:
+    *recipient = static_cast<std::uint8_t>(value);
+    break;
+  case 2:
+    write<std::uint16_t>(recipient, value);
+    break;
+  case 4:
+    write<std::uint32_t>(recipient, value);
+    break;
+  default:
+    write<std::uint64_t>(recipient, value);
+    break;
+  }
+}
+} // namespace
+
+CombinationMatrix::CombinationMatrix(std::size_t columns, std::size_t max_value)
+    : columns_{columns}, width_{width_for(max_value)} {}
+
+CombinationMatrix::CombinationMatrix(
+    const std::vector<std::vector<std::size_t>> &combinations)
+    : columns_{combinations.empty() ? 0 : combinations.front().size()} {
+  std::size_t max_value = 0;
+  for (const auto &combination : combinations) {
+    if (combination.size() != columns_) {
+      throw Error{"Combinations with different sizes"};
+    }
+    for (auto value : combination) {
+      max_value = std::max(max_value, value);
+    }
+  }
+  width_ = width_for(max_value);
+  reserve(combinations.size());
+  for (const auto &combination : combinations) {
+    push_back_(combination);
+  }
+}
+
+CombinationMatrix::CombinationMatrix(std::shared_ptr<const void> owner,
+                                     const std::uint8_t *buffer,
+                                     std::size_t rows, std::size_t columns,
+                                     std::size_t width)
+    : columns_{columns}, rows_{rows}, width_{width}, owner_{std::move(owner)},
+      aliased_{buffer} {
+  if ((width != 1) && (width != 2) && (width != 4) && (width != 8)) {
+    throw Error::make(width, "is an invalid width for the values");
+  }
+}
+
+void CombinationMatrix::push_back(const std::vector<std::size_t> &combination) {
+  push_back_(combination);
+}
+
+void CombinationMatrix::push_back(const Row &combination) {
+  const auto row_bytes = combination.bytes();
+  const auto all_bytes = bytes();
+  const std::less<const char *> less;
+  if (!less(row_bytes.data(), all_bytes.data()) &&
+      less(row_bytes.data(), all_bytes.data() + all_bytes.size())) {
+    // a row of this matrix is copied, as the addition may reallocate or
+    // release the memory it refers to
+    push_back_(static_cast<std::vector<std::size_t>>(combination));
+    return;
+  }
+  push_back_(combination);
+}
+
+template <typename Combination>
+void CombinationMatrix::push_back_(const Combination &combination) {
+  if (combination.size() != columns_) {
+    throw Error::make("Expected a combination of size", columns_, "instead of",
+                      combination.size());
+  }
+  std::size_t max_value = 0;
+  for (std::size_t k = 0; k < columns_; ++k) {
+    max_value = std::max(max_value, combination[k]);
+  }
+  detach();
+  if (width_ < width_for(max_value)) {
+    widen(max_value);
+  }
+  const std::size_t offset = buffer_.size();
+  buffer_.resize(offset + columns_ * width_);
+  std::uint8_t *recipient = buffer_.data() + offset;
+  for (std::size_t k = 0; k < columns_; ++k, recipient += width_) {
+    write(recipient, width_, combination[k]);
+  }
+  ++rows_;
+}
+
+void CombinationMatrix::widen(std::size_t max_value) {
+  const std::size_t new_width = width_for(max_value);
+  std::vector<std::uint8_t> new_buffer;
+  new_buffer.resize(rows_ * columns_ * new_width);
+  std::uint8_t *recipient = new_buffer.data();
+  for (std::size_t r = 0; r < rows_; ++r) {
+    const auto row = (*this)[r];
+    for (std::size_t k = 0; k < columns_; ++k, recipient += new_width) {
+      write(recipient, new_width, row[k]);
+    }
+  }
+  buffer_ = std::move(new_buffer);
+  width_ = new_width;
+}
+
+void CombinationMatrix::detach() {
+  if (isAliased()) {
+    buffer_.assign(aliased_, aliased_ + rows_ * columns_ * width_);
+    owner_.reset();
+    aliased_ = nullptr;
+  }
+}
+
+CombinationMatrix::operator std::vector<std::vector<std::size_t>>() const {
+  std::vector<std::vector<std::size_t>> result;
+  result.reserve(rows_);
+  for (const auto row : *this) {
+    result.emplace_back(row);
+  }
+  return result;
+}
+} // namespace EFG::categoric
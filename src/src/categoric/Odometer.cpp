@@ -0,0 +1,57 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#include <EasyFactorGraph/Error.h>
+#include <EasyFactorGraph/categoric/Odometer.h>
+
+namespace EFG::categoric {
+std::size_t domain_size(const std::vector<std::size_t> &sizes) {
+  std::size_t result = 1;
+  for (auto size : sizes) {
+    result *= size;
+  }
+  return result;
+}
+
+Odometer::Odometer(const std::vector<std::size_t> &sizes)
+    : Odometer{sizes, 0, domain_size(sizes)} {}
+
+Odometer::Odometer(const std::vector<std::size_t> &sizes, std::size_t begin,
+                   std::size_t end)
+    : sizes{&sizes}, end{end} {
+  if ((end < begin) || (domain_size(sizes) < end)) {
+    throw Error{"Invalid Odometer range"};
+  }
+  combination_.resize(sizes.size());
+  seek(begin);
+}
+
+void Odometer::seek(std::size_t flat) {
+  counter = flat;
+  for (std::size_t k = combination_.size(); k > 0; --k) {
+    const std::size_t size = (*sizes)[k - 1];
+    combination_[k - 1] = flat % size;
+    flat /= size;
+  }
+}
+
+std::vector<std::pair<std::size_t, std::size_t>>
+partition_domain(std::size_t domain_size, std::size_t chunks) {
+  chunks = std::max<std::size_t>(1, std::min(chunks, domain_size));
+  std::vector<std::pair<std::size_t, std::size_t>> result;
+  result.reserve(chunks);
+  const std::size_t base = domain_size / chunks;
+  const std::size_t remainder = domain_size % chunks;
+  std::size_t begin = 0;
+  for (std::size_t c = 0; c < chunks; ++c) {
+    const std::size_t end = begin + base + ((c < remainder) ? 1 : 0);
+    result.emplace_back(begin, end);
+    begin = end;
+  }
+  return result;
+}
+} // namespace EFG::categoric
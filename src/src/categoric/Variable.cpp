@@ -8,11 +8,79 @@
 #include <EasyFactorGraph/Error.h>
 #include <EasyFactorGraph/categoric/Variable.h>
 
+#include <array>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
 namespace EFG::categoric {
+namespace {
+// Interns the names of the variables. Names are split into shards, each with
+// its own lock, so that variables built by different threads rarely contend.
+// Looking up an already interned name only takes a shared lock.
+// Interned names are reference counted: a name is removed as soon as the last
+// variable having it is destroyed.
+class NamesRegister {
+public:
+  static NamesRegister &get() {
+    // never destroyed, as variables may outlive the static objects
+    static NamesRegister *res = new NamesRegister{};
+    return *res;
+  }
+
+  std::shared_ptr<const InternedName> intern(const std::string &name) {
+    if (name.size() == 0)
+      throw Error("Empty name for Variable forbidden");
+    auto &shard = shards[std::hash<std::string>{}(name) % SHARDS];
+    {
+      std::shared_lock lock(shard.mtx);
+      if (auto it = shard.names.find(name); it != shard.names.end()) {
+        if (auto interned = it->second.lock()) {
+          return interned;
+        }
+      }
+    }
+    std::scoped_lock lock(shard.mtx);
+    auto &entry = shard.names[name];
+    if (auto interned = entry.lock()) {
+      // interned meanwhile by another thread
+      return interned;
+    }
+    std::shared_ptr<const InternedName> interned{
+        new InternedName{name, next_id++},
+        [&shard](const InternedName *released) {
+          {
+            std::scoped_lock lock(shard.mtx);
+            auto it = shard.names.find(released->name);
+            // the name may have been interned again in the meantime
+            if ((it != shard.names.end()) && it->second.expired()) {
+              shard.names.erase(it);
+            }
+          }
+          delete released;
+        }};
+    entry = interned;
+    return interned;
+  }
+
+private:
+  NamesRegister() = default;
+
+  static constexpr std::size_t SHARDS = 16;
+
+  struct Shard {
+    std::shared_mutex mtx;
+    std::unordered_map<std::string, std::weak_ptr<const InternedName>> names;
+  };
+  std::array<Shard, SHARDS> shards;
+  std::atomic<std::size_t> next_id = 0;
+};
+} // namespace
+
 Variable::Variable(std::size_t size, const std::string &name)
-    : size_(size), name_(name) {
-  if (name.size() == 0)
-    throw Error("Empty name for Variable forbidden");
+    : size_(size), name_(NamesRegister::get().intern(name)) {
   if (size == 0)
     throw Error("Null size for Variable forbidden");
 }
@@ -6,9 +6,12 @@
  **/
 
 #include <EasyFactorGraph/Error.h>
-#include <EasyFactorGraph/categoric/GroupRange.h>
+#include <EasyFactorGraph/categoric/Odometer.h>
 // #include <EasyFactorGraph/factor/CombinationFinder.h>
 #include <EasyFactorGraph/factor/Factor.h>
+#include <EasyFactorGraph/structure/bases/PoolAware.h>
+
+#include <algorithm>
 
 namespace EFG::factor {
 Factor::Factor(FunctionPtr data) : Immutable{data}, Mutable{data} {}
@@ -132,41 +135,238 @@ gather_variables(const std::vector<const Immutable *> &factors) {
 }
 } // namespace
 
-Factor::Factor(const std::vector<const Immutable *> &factors)
-    : Factor(gather_variables(factors)) {
-  if (factors.empty()) {
-    throw Error{"Empty factors container"};
+namespace {
+// Computes the product of many factors, over the joint domain of all their
+// variables. The result is computed by rows, i.e. slices along the last
+// variable of the result: every factor contributes to a row with a strided
+// (possibly contiguous) sequence of images, or with a single value broadcast
+// to the entire row when the factor does not depend on the last variable.
+// Rows for which a broadcast value is 0 are skipped.
+// Used when merge_sparse_factors can't be adopted.
+class MergeEngine {
+public:
+  MergeEngine(const std::vector<const Immutable *> &factors,
+              const Function::Info &result_info,
+              const categoric::VariablesSoup &result_vars)
+      : result_info{result_info} {
+    const std::size_t dims = result_vars.size();
+    outer_sizes = {result_info.sizes.begin(), result_info.sizes.end() - 1};
+    for (const auto *factor : factors) {
+      Contribution contribution;
+      const auto &vars = factor->function().vars().getVariables();
+      const auto &strides = factor->function().getInfo().strides;
+      contribution.strides.resize(dims, 0);
+      for (std::size_t k = 0; k < vars.size(); ++k) {
+        auto it = std::find(result_vars.begin(), result_vars.end(), vars[k]);
+        contribution.strides[std::distance(result_vars.begin(), it)] =
+            strides[k];
+      }
+      contribution.images.reserve(factor->function().getInfo().totCombinations);
+      factor->function().forEachCombination<true>(
+          [&images = contribution.images](const auto &, float img) {
+            images.push_back(img);
+          });
+      contributions.emplace_back(std::move(contribution));
+    }
+    // broadcast contributions first, as they may allow to skip an entire row
+    std::stable_sort(contributions.begin(), contributions.end(),
+                     [](const Contribution &a, const Contribution &b) {
+                       return (a.strides.back() == 0) &&
+                              (b.strides.back() != 0);
+                     });
   }
 
-  std::vector<const Immutable *> same_size_factors;
-  std::vector<ImageFinder> finders;
+  std::size_t rowsNumber() const {
+    return result_info.totCombinations / result_info.sizes.back();
+  }
+
+  // fills the rows in [rows_begin, rows_end)
+  void compute(std::vector<float> &result, std::size_t rows_begin,
+               std::size_t rows_end) const {
+    const std::size_t row_size = result_info.sizes.back();
+    categoric::Odometer outer{outer_sizes, rows_begin, rows_end};
+    std::vector<std::size_t> bases;
+    bases.resize(contributions.size());
+    for (; !outer.done(); outer.next()) {
+      const auto &comb = outer.combination();
+      for (std::size_t c = 0; c < contributions.size(); ++c) {
+        const auto &strides = contributions[c].strides;
+        std::size_t base = 0;
+        for (std::size_t k = 0; k < comb.size(); ++k) {
+          base += comb[k] * strides[k];
+        }
+        bases[c] = base;
+      }
+      float *row = result.data() + outer.flat() * row_size;
+      std::fill(row, row + row_size, 1.f);
+      for (std::size_t c = 0; c < contributions.size(); ++c) {
+        const float *images = contributions[c].images.data() + bases[c];
+        const std::size_t stride = contributions[c].strides.back();
+        if (0 == stride) {
+          if (0 == *images) {
+            std::fill(row, row + row_size, 0.f);
+            break;
+          }
+          for (std::size_t i = 0; i < row_size; ++i) {
+            row[i] *= *images;
+          }
+        } else if (1 == stride) {
+          for (std::size_t i = 0; i < row_size; ++i) {
+            row[i] *= images[i];
+          }
+        } else {
+          for (std::size_t i = 0; i < row_size; ++i) {
+            row[i] *= images[i * stride];
+          }
+        }
+      }
+    }
+  }
+
+private:
+  const Function::Info &result_info;
+  std::vector<std::size_t> outer_sizes;
+
+  struct Contribution {
+    // stride of each variable of the result in the images of the factor. 0
+    // for the variables not involved in the factor.
+    std::vector<std::size_t> strides;
+    // transformed images
+    std::vector<float> images;
+  };
+  std::vector<Contribution> contributions;
+};
 
+// Sparse counterpart of MergeEngine: when a factor has a null transformed
+// image for most of its combinations, only the combinations of the result
+// extending its non null ones are visited.
+// Returns false, leaving the recipient untouched, when such a factor does not
+// exist, or when the result would not be sparse anyway.
+bool merge_sparse_factors(Function &recipient,
+                          const std::vector<const Immutable *> &factors) {
+  const auto &info = recipient.getInfo();
+  const Immutable *sparsest = nullptr;
+  // upper bound for the non null images of the result
+  std::size_t non_null_bound = info.critical_size;
   for (const auto *factor : factors) {
-    if (factor->function().vars().getVariables() ==
-        function().vars().getVariables()) {
-      same_size_factors.push_back(factor);
-    } else {
-      finders.emplace_back(
-          factor->makeFinder(function().vars().getVariables()));
+    const auto non_null = factor->function().sparseNonNullSize();
+    if (!non_null.has_value()) {
+      continue;
+    }
+    const std::size_t bound =
+        non_null.value() *
+        (info.totCombinations / factor->function().getInfo().totCombinations);
+    if (bound < non_null_bound) {
+      sparsest = factor;
+      non_null_bound = bound;
     }
   }
+  if (sparsest == nullptr) {
+    return false;
+  }
 
-  categoric::GroupRange range(function().vars());
-  auto &recipient = functionMutable();
-  categoric::for_each_combination(range, [&recipient, &same_size_factors,
-                                          &finders](const auto &comb) {
-    float val = 1.f;
-    for (auto it = same_size_factors.begin();
-         (it != same_size_factors.end()) && (val != 0); ++it) {
-      val *= (*it)->function().findTransformed(comb);
+  const auto &result_vars = recipient.vars().getVariables();
+  const auto &sparsest_vars = sparsest->function().vars().getVariables();
+  std::vector<std::size_t> sparsest_positions;
+  for (const auto &var : sparsest_vars) {
+    auto it = std::find(result_vars.begin(), result_vars.end(), var);
+    sparsest_positions.push_back(std::distance(result_vars.begin(), it));
+  }
+  std::vector<std::size_t> other_positions, other_sizes;
+  for (std::size_t p = 0; p < result_vars.size(); ++p) {
+    if (std::find(sparsest_positions.begin(), sparsest_positions.end(), p) ==
+        sparsest_positions.end()) {
+      other_positions.push_back(p);
+      other_sizes.push_back(result_vars[p]->size());
     }
-    for (auto it = finders.begin(); (it != finders.end()) && (val != 0); ++it) {
-      val *= it->findTransformed(comb);
+  }
+  std::vector<ImageFinder> finders;
+  for (const auto *factor : factors) {
+    if (factor != sparsest) {
+      finders.emplace_back(factor->makeFinder(result_vars));
     }
-    if (val != 0) {
-      recipient.set(comb, val);
+  }
+
+  std::vector<std::size_t> comb;
+  comb.resize(result_vars.size());
+  sparsest->function().forEachNonNullCombination<true>(
+      [&](const std::vector<std::size_t> &sparse_comb, float sparse_img) {
+        for (std::size_t k = 0; k < sparse_comb.size(); ++k) {
+          comb[sparsest_positions[k]] = sparse_comb[k];
+        }
+        categoric::Odometer others{other_sizes};
+        for (; !others.done(); others.next()) {
+          for (std::size_t k = 0; k < other_positions.size(); ++k) {
+            comb[other_positions[k]] = others.combination()[k];
+          }
+          float img = sparse_img;
+          for (auto it = finders.begin(); (it != finders.end()) && (img != 0);
+               ++it) {
+            img *= it->findTransformed(comb);
+          }
+          if (img != 0) {
+            recipient.set(comb, img);
+          }
+        }
+      });
+  return true;
+}
+
+void merge_factors(Function &recipient,
+                   const std::vector<const Immutable *> &factors,
+                   strct::Pool *pool) {
+  if (merge_sparse_factors(recipient, factors)) {
+    return;
+  }
+  const auto &info = recipient.getInfo();
+  MergeEngine engine{factors, info, recipient.vars().getVariables()};
+  std::vector<float> images;
+  images.resize(info.totCombinations);
+  const std::size_t chunks = (pool == nullptr) ? 1 : pool->size();
+  const auto partitions =
+      categoric::partition_domain(engine.rowsNumber(), chunks);
+  if (partitions.size() == 1) {
+    engine.compute(images, 0, engine.rowsNumber());
+  } else {
+    strct::Tasks tasks;
+    for (const auto &[begin, end] : partitions) {
+      tasks.emplace_back([&engine, &images, begin = begin,
+                          end = end](const std::size_t) {
+        engine.compute(images, begin, end);
+      });
     }
-  });
+    pool->parallelFor(tasks);
+  }
+  const std::size_t non_null =
+      images.size() - std::count(images.begin(), images.end(), 0.f);
+  if (non_null >= info.critical_size) {
+    recipient.setDenseImages(std::move(images));
+    return;
+  }
+  categoric::Odometer range{info.sizes};
+  for (; !range.done(); range.next()) {
+    if (float img = images[range.flat()]; img != 0) {
+      recipient.set(range.combination(), img);
+    }
+  }
+}
+} // namespace
+
+Factor::Factor(const std::vector<const Immutable *> &factors)
+    : Factor(gather_variables(factors)) {
+  if (factors.empty()) {
+    throw Error{"Empty factors container"};
+  }
+  merge_factors(functionMutable(), factors, nullptr);
+}
+
+Factor::Factor(const std::vector<const Immutable *> &factors,
+               strct::Pool &pool)
+    : Factor(gather_variables(factors)) {
+  if (factors.empty()) {
+    throw Error{"Empty factors container"};
+  }
+  merge_factors(functionMutable(), factors, &pool);
 }
 
 namespace {
@@ -192,6 +392,93 @@ get_permuted(const std::vector<std::size_t> &subject,
   }
   return result;
 }
+
+// Tensor transpose of the dense images of the source into the destination
+// buffer. The destination is filled by rows (its last dimension). When the
+// last dimension of the source ends up in another position, the 2 dimensions
+// are transposed in square blocks, in order to keep both reads and writes
+// cache friendly.
+class PermutationKernel {
+public:
+  PermutationKernel(const Function::Info &source,
+                    const Function::Info &destination,
+                    const std::vector<std::size_t> &new_positions)
+      : dst_sizes{destination.sizes}, dst_strides{destination.strides} {
+    const std::size_t dims = dst_sizes.size();
+    src_strides.resize(dims);
+    for (std::size_t p = 0; p < dims; ++p) {
+      src_strides[new_positions[p]] = source.strides[p];
+    }
+    row_dim = dims - 1;
+    column_dim = new_positions.back();
+    for (std::size_t d = 0; d < dims; ++d) {
+      if ((d != row_dim) && (d != column_dim)) {
+        outer_dims.push_back(d);
+        outer_sizes.push_back(dst_sizes[d]);
+      }
+    }
+  }
+
+  void apply(const float *source, std::vector<float> &destination) const {
+    categoric::Odometer outer{outer_sizes};
+    for (; !outer.done(); outer.next()) {
+      std::size_t dst_base = 0;
+      std::size_t src_base = 0;
+      const auto &comb = outer.combination();
+      for (std::size_t k = 0; k < outer_dims.size(); ++k) {
+        dst_base += comb[k] * dst_strides[outer_dims[k]];
+        src_base += comb[k] * src_strides[outer_dims[k]];
+      }
+      if (row_dim == column_dim) {
+        copyRow(source + src_base, destination.data() + dst_base);
+      } else {
+        transposeSlice(source + src_base, destination.data() + dst_base);
+      }
+    }
+  }
+
+private:
+  void copyRow(const float *src, float *dst) const {
+    const std::size_t size = dst_sizes[row_dim];
+    const std::size_t stride = src_strides[row_dim];
+    for (std::size_t k = 0; k < size; ++k, src += stride) {
+      dst[k] = *src;
+    }
+  }
+
+  static constexpr std::size_t BLOCK = 16;
+
+  void transposeSlice(const float *src, float *dst) const {
+    const std::size_t rows = dst_sizes[column_dim];
+    const std::size_t columns = dst_sizes[row_dim];
+    const std::size_t dst_row_stride = dst_strides[column_dim];
+    const std::size_t src_column_stride = src_strides[row_dim];
+    for (std::size_t r0 = 0; r0 < rows; r0 += BLOCK) {
+      const std::size_t r_end = std::min(rows, r0 + BLOCK);
+      for (std::size_t c0 = 0; c0 < columns; c0 += BLOCK) {
+        const std::size_t c_end = std::min(columns, c0 + BLOCK);
+        for (std::size_t r = r0; r < r_end; ++r) {
+          float *dst_row = dst + r * dst_row_stride;
+          const float *src_row = src + r;
+          for (std::size_t c = c0; c < c_end; ++c) {
+            dst_row[c] = src_row[c * src_column_stride];
+          }
+        }
+      }
+    }
+  }
+
+  const std::vector<std::size_t> &dst_sizes;
+  const std::vector<std::size_t> &dst_strides;
+  // strides of the source, in the order of the destination dimensions
+  std::vector<std::size_t> src_strides;
+  // last dimension of the destination
+  std::size_t row_dim;
+  // position in the destination of the last dimension of the source
+  std::size_t column_dim;
+  std::vector<std::size_t> outer_dims;
+  std::vector<std::size_t> outer_sizes;
+};
 } // namespace
 
 Factor Factor::cloneWithPermutedGroup(const categoric::Group &new_order) const {
@@ -202,10 +489,18 @@ Factor Factor::cloneWithPermutedGroup(const categoric::Group &new_order) const {
   auto data = std::make_shared<Function>(new_order);
   const auto new_positions = compute_new_positions(
       function().vars().getVariables(), data->vars().getVariables());
-  function().forEachCombination<false>(
-      [&recipient = *data, &new_positions](const auto &comb, float img) {
-        recipient.set(get_permuted(comb, new_positions), img);
-      });
+  if (const auto *images = function().getDenseImages(); images) {
+    std::vector<float> permuted;
+    permuted.resize(images->size());
+    PermutationKernel{function().getInfo(), data->getInfo(), new_positions}
+        .apply(images->data(), permuted);
+    data->setDenseImages(std::move(permuted));
+  } else {
+    function().forEachNonNullCombination<false>(
+        [&recipient = *data, &new_positions](const auto &comb, float img) {
+          recipient.set(get_permuted(comb, new_positions), img);
+        });
+  }
   return data;
 }
 } // namespace EFG::factor
@@ -5,6 +5,7 @@
  * report any bug to andrecasa91@gmail.com.
  **/
 
+#include <EasyFactorGraph/Error.h>
 #include <EasyFactorGraph/categoric/GroupRange.h>
 #include <EasyFactorGraph/factor/FactorExponential.h>
 #include <math.h>
@@ -21,6 +22,11 @@ class ExponentialFunction : public Function {
 public:
   ExponentialFunction(const Function &giver, float w)
       : Function{giver.vars()}, weigth{w} {
+    if (giver.getDenseImages() != nullptr) {
+      // aliased images are shared, not copied
+      cloneImages(giver);
+      return;
+    }
     std::vector<float> imgs;
     imgs.reserve(info->totCombinations);
     giver.forEachCombination<false>(
@@ -28,14 +34,30 @@ public:
     data_ = std::move(imgs);
   }
 
-  void setWeight(float w) { weigth = w; };
-  float getWeight() const { return weigth; };
+  void setWeight(float w) {
+    if (slot.has_value()) {
+      slot->buffer->set(slot->position, w);
+      return;
+    }
+    weigth = w;
+  };
+  float getWeight() const {
+    return slot.has_value() ? (*slot->buffer)[slot->position] : weigth;
+  };
+
+  void bind(WeightSlot new_slot) { slot.emplace(std::move(new_slot)); }
+  const std::optional<WeightSlot> &getSlot() const { return slot; }
 
 protected:
-  float transform(float input) const override { return expf(weigth * input); }
+  float transform(float input) const override {
+    return expf(getWeight() * input);
+  }
+
+  float transformKey() const override { return getWeight(); }
 
 private:
   float weigth;
+  std::optional<WeightSlot> slot;
 };
 } // namespace
 
@@ -51,6 +73,22 @@ float FactorExponential::getWeight() const {
   return static_cast<const ExponentialFunction &>(function()).getWeight();
 }
 
+void FactorExponential::bindWeight(const WeightsBufferPtr &buffer,
+                                   std::size_t position) {
+  if (buffer == nullptr) {
+    throw Error{"null weights buffer"};
+  }
+  if (buffer->size() <= position) {
+    throw Error::make(position, " is out of the weights buffer");
+  }
+  static_cast<ExponentialFunction &>(functionMutable())
+      .bind(WeightSlot{buffer, position});
+}
+
+std::optional<WeightSlot> FactorExponential::getWeightSlot() const {
+  return static_cast<const ExponentialFunction &>(function()).getSlot();
+}
+
 FactorExponential::FactorExponential(const FactorExponential &o)
     : FactorExponential{
           std::make_shared<ExponentialFunction>(o.function(), o.getWeight())} {}
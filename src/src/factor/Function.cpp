@@ -5,6 +5,7 @@
  * report any bug to andrecasa91@gmail.com.
  **/
 
+#include <EasyFactorGraph/Error.h>
 #include <EasyFactorGraph/factor/Function.h>
 
 #include <math.h>
@@ -33,6 +34,12 @@ std::shared_ptr<const Function::Info> make_info(const categoric::Group &vars) {
     res->sizes.push_back(var->size());
   }
   res->totCombinations = sizes_prod(res->sizes);
+  res->strides.resize(res->sizes.size());
+  std::size_t stride = 1;
+  for (std::size_t k = res->sizes.size(); k > 0; --k) {
+    res->strides[k - 1] = stride;
+    stride *= res->sizes[k - 1];
+  }
   res->critical_size = std::max<std::size_t>(
       compute_critical_size(res->totCombinations, 0.5f), MIN_CRITICAL);
   return res;
@@ -48,22 +55,21 @@ Function::Function(const categoric::Group &variables)
 
 std::size_t Function::CombinationHasher::operator()(
     const std::vector<std::size_t> &comb) const {
-  auto prod = info->totCombinations;
   std::size_t res = 0;
-  for (std::size_t k = 0; k < info->sizes.size(); ++k) {
-    prod /= info->sizes[k];
-    res += comb[k] * prod;
+  for (std::size_t k = 0; k < info->strides.size(); ++k) {
+    res += comb[k] * info->strides[k];
   }
   return res;
 }
 
 void Function::set(const std::vector<std::size_t> &combination, float image) {
+  imagesChanged();
   Visitor<SparseContainer, DenseContainer>{
       [&combination, image = image, critical_size = info->critical_size,
        info = info, &data = data_](SparseContainer &c) {
         c[combination] = image;
         if (c.size() >= critical_size) {
-          DenseContainer values;
+          std::vector<float> values;
           values.resize(info->totCombinations);
           for (auto &v : values) {
             v = 0;
@@ -81,6 +87,45 @@ void Function::set(const std::vector<std::size_t> &combination, float image) {
       .visit(data_);
 }
 
+void Function::setDenseImages(std::vector<float> images) {
+  if (images.size() != info->totCombinations) {
+    throw Error::make("Expected ", std::to_string(info->totCombinations),
+                      " images, while received ",
+                      std::to_string(images.size()));
+  }
+  data_ = std::move(images);
+  imagesChanged();
+}
+
+void Function::aliasDenseImages(std::shared_ptr<const void> owner,
+                                const float *images) {
+  data_ = DenseContainer{std::move(owner), images, info->totCombinations};
+  imagesChanged();
+}
+
+std::shared_ptr<const std::vector<float>>
+Function::getTransformedImages() const {
+  const float key = transformKey();
+  auto &cache = transformed_cache;
+  {
+    std::scoped_lock lock(cache.mtx);
+    if ((cache.images != nullptr) &&
+        (cache.images_version == images_version) &&
+        (cache.transform_key == key)) {
+      return cache.images;
+    }
+  }
+  auto images = std::make_shared<std::vector<float>>();
+  images->reserve(info->totCombinations);
+  forEachCombination<true>(
+      [&images](const auto &, float img) { images->push_back(img); });
+  std::scoped_lock lock(cache.mtx);
+  cache.images = images;
+  cache.images_version = images_version;
+  cache.transform_key = key;
+  return images;
+}
+
 float Function::findImage(const std::vector<std::size_t> &combination) const {
   float res;
   VisitorConst<SparseContainer, DenseContainer>{
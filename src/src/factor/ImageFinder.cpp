@@ -48,15 +48,46 @@ ImageFinder::ImageFinder(std::shared_ptr<const Function> function,
                          const categoric::VariablesSoup &bigger_group)
     : function_{function},
       indices_in_bigger_group(
-          get_indices(function_->vars().getVariables(), bigger_group)) {}
-
-std::vector<std::size_t> ImageFinder::extractSmallerCombination(
-    const std::vector<std::size_t> &comb) const {
-  std::vector<std::size_t> res;
-  res.reserve(indices_in_bigger_group.size());
-  for (auto index : indices_in_bigger_group) {
-    res.push_back(comb[index]);
+          get_indices(function_->vars().getVariables(), bigger_group)),
+      strides(function_->getInfo().strides) {}
+
+float ImageFinder::findSparseImage(const std::vector<std::size_t> &comb) const {
+  // avoid allocating a new sub combination at every call
+  thread_local std::vector<std::size_t> sub_comb;
+  sub_comb.resize(indices_in_bigger_group.size());
+  for (std::size_t k = 0; k < indices_in_bigger_group.size(); ++k) {
+    sub_comb[k] = comb[indices_in_bigger_group[k]];
+  }
+  return function_->findImage(sub_comb);
+}
+
+float ImageFinder::findImage(const std::vector<std::size_t> &comb) const {
+  if (const auto *images = function_->getDenseImages(); images) {
+    return (*images)[flatIndex(comb)];
+  }
+  return findSparseImage(comb);
+}
+
+float ImageFinder::findTransformed(const std::vector<std::size_t> &comb) const {
+  return function_->transform(findImage(comb));
+}
+
+void ImageFinder::findImages(
+    const std::vector<std::vector<std::size_t>> &combinations,
+    std::vector<float> &recipient) const {
+  recipient.resize(combinations.size());
+  auto recipient_it = recipient.begin();
+  if (const auto *images = function_->getDenseImages(); images) {
+    const float *data = images->data();
+    for (const auto &comb : combinations) {
+      *recipient_it = data[flatIndex(comb)];
+      ++recipient_it;
+    }
+    return;
+  }
+  for (const auto &comb : combinations) {
+    *recipient_it = findSparseImage(comb);
+    ++recipient_it;
   }
-  return res;
 }
 } // namespace EFG::factor
@@ -0,0 +1,47 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#include <EasyFactorGraph/factor/WeightsBuffer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace EFG::factor {
+namespace {
+float *allocate(std::size_t capacity) {
+  return static_cast<float *>(::operator new(
+      capacity * sizeof(float), std::align_val_t{WeightsBuffer::ALIGNMENT}));
+}
+
+void deallocate(float *values) {
+  ::operator delete(values, std::align_val_t{WeightsBuffer::ALIGNMENT});
+}
+} // namespace
+
+WeightsBuffer::~WeightsBuffer() {
+  if (values != nullptr) {
+    deallocate(values);
+  }
+}
+
+std::size_t WeightsBuffer::push_back(float weight) {
+  if (size_ == capacity) {
+    const std::size_t new_capacity =
+        std::max<std::size_t>(ALIGNMENT / sizeof(float), 2 * capacity);
+    float *new_values = allocate(new_capacity);
+    if (values != nullptr) {
+      std::memcpy(new_values, values, size_ * sizeof(float));
+      deallocate(values);
+    }
+    values = new_values;
+    capacity = new_capacity;
+  }
+  values[size_] = weight;
+  return size_++;
+}
+} // namespace EFG::factor
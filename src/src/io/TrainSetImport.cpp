@@ -9,25 +9,64 @@
 
 #include "Utils.h"
 
+#include <cctype>
+#include <charconv>
+#include <optional>
+
 namespace EFG::io {
 
-train::TrainSet import_train_set(const std::string &file_name) {
-  std::vector<std::vector<std::size_t>> combinations;
+namespace {
+void parse_values(const std::string &line, std::vector<std::size_t> &recipient,
+                  std::size_t line_numb) {
+  recipient.clear();
+  const char *cursor = line.data();
+  const char *end = cursor + line.size();
+  while (cursor != end) {
+    if (std::isspace(static_cast<unsigned char>(*cursor))) {
+      ++cursor;
+      continue;
+    }
+    std::size_t value;
+    auto [next, error] = std::from_chars(cursor, end, value);
+    if (error != std::errc{}) {
+      throw Error::make("Invalid value at line", std::to_string(line_numb));
+    }
+    recipient.push_back(value);
+    cursor = next;
+  }
+}
+} // namespace
+
+categoric::CombinationMatrix
+import_combinations(const std::filesystem::path &file_name) {
+  std::optional<categoric::CombinationMatrix> combinations;
   useInStrem(file_name, [&combinations](std::ifstream &stream) {
     std::size_t line_numb = 0;
-    std::size_t expected_size = 0;
+    std::vector<std::size_t> combination;
     for_each_line(stream, [&](const std::string &line) {
-      auto &&[combination, img] = parse_combination_image(line);
-      if ((expected_size != 0) && (combination.size() != expected_size)) {
-        throw Error::make("Invalid combination size at line ",
+      ++line_numb;
+      parse_values(line, combination, line_numb);
+      if (combination.empty()) {
+        return;
+      }
+      if (!combinations.has_value()) {
+        combinations.emplace(combination.size());
+      }
+      if (combination.size() != combinations->columns()) {
+        throw Error::make("Invalid combination size at line",
                           std::to_string(line_numb));
       }
-      expected_size = combination.size();
-      combinations.emplace_back(std::move(expected_size));
-      ++line_numb;
+      combinations->push_back(combination);
     });
   });
-  return train::TrainSet{combinations};
+  if (!combinations.has_value()) {
+    throw Error{"empty train set"};
+  }
+  return std::move(combinations.value());
+}
+
+train::TrainSet import_train_set(const std::string &file_name) {
+  return train::TrainSet{import_combinations(file_name)};
 }
 
 } // namespace EFG::io
@@ -45,33 +45,63 @@ void import_values(factor::Factor &recipient,
   });
 }
 
-void ImportHelper::importConst(const factor::ImmutablePtr &factor) {
-  std::get<strct::FactorsConstInserter *>(model)->addConstFactor(factor);
+categoric::VariablePtr find_variable(const VariablesIndex &variables,
+                                     const std::string &name) {
+  auto it = variables.find(name);
+  if (it == variables.end()) {
+    throw Error("Inexistent variable");
+  }
+  return it->second;
 }
 
-void ImportHelper::importTunable(
-    const std::shared_ptr<factor::FactorExponential> &factor,
-    const std::optional<categoric::VariablesSet> &sharing_group) {
-  if (auto ptr = std::get<train::FactorsTunableInserter *>(model); ptr) {
-    if (sharing_group.has_value()) {
-      this->cumulated.push_back(TunableCluster{factor, sharing_group.value()});
-    } else {
-      ptr->addTunableFactor(factor);
-    }
-    return;
+void add_variable(VariablesIndex &variables,
+                  const categoric::VariablePtr &variable) {
+  if (!variables.emplace(variable->name(), variable).second) {
+    throw Error::make(variable->name(),
+                      " is a multiple times specified variable ");
   }
-  std::get<strct::FactorsConstInserter *>(model)->addConstFactor(factor);
 }
 
-void ImportHelper::importCumulatedTunable() const {
+void ImportHelper::import(const std::vector<Parsed> &parsed) {
   auto [constInserter, tunableInserter] = model;
-  for (const auto &remaining : cumulated) {
-    if (tunableInserter) {
-      tunableInserter->addTunableFactor(remaining.factor,
-                                        remaining.group_owning_w_to_share);
+  std::vector<factor::ImmutablePtr> const_factors;
+  std::vector<train::FactorsTunableInserter::TunableFactorToAdd>
+      tunable_factors;
+  auto flush = [&]() {
+    if (!const_factors.empty()) {
+      constInserter->addConstFactors(const_factors);
+      const_factors.clear();
+    }
+    if (!tunable_factors.empty()) {
+      tunableInserter->addTunableFactors(tunable_factors);
+      tunable_factors.clear();
+    }
+  };
+  for (const auto &[constant, tunable, sharing_group] : parsed) {
+    if (tunable && tunableInserter) {
+      if (sharing_group.has_value()) {
+        cumulated.push_back({tunable, sharing_group});
+        continue;
+      }
+      if (!const_factors.empty()) {
+        flush();
+      }
+      tunable_factors.push_back({tunable});
       continue;
     }
-    constInserter->addConstFactor(remaining.factor);
+    if (!tunable_factors.empty()) {
+      flush();
+    }
+    const_factors.push_back(tunable ? tunable : constant);
+  }
+  flush();
+}
+
+void ImportHelper::importCumulatedTunable() const {
+  // filled only when the model is a FactorsTunableInserter
+  if (!cumulated.empty()) {
+    std::get<train::FactorsTunableInserter *>(model)->addTunableFactors(
+        cumulated);
   }
 }
 
@@ -8,11 +8,15 @@
 #pragma once
 
 #include <EasyFactorGraph/Error.h>
+#include <EasyFactorGraph/categoric/Odometer.h>
 #include <EasyFactorGraph/io/ModelComponents.h>
+#include <EasyFactorGraph/structure/bases/PoolAware.h>
 #include <EasyFactorGraph/trainable/TrainSet.h>
 
+#include <exception>
 #include <filesystem>
 #include <fstream>
+#include <unordered_map>
 #include <utility>
 
 namespace EFG::io {
@@ -74,22 +78,107 @@ void import_values(factor::Factor &recipient,
  */
 train::TrainSet import_train_set(const std::string &file_name);
 
+/**
+ * @brief Similar to import_train_set, returning the parsed combinations.
+ * @throw in case the passed file is inexistent
+ * @throw in case not all the combinations in file have the same size
+ * @throw in case some values are not non negative integers
+ */
+categoric::CombinationMatrix
+import_combinations(const std::filesystem::path &file_name);
+
+/**
+ * @brief The variables of an imported model, indexed by name.
+ */
+using VariablesIndex = std::unordered_map<std::string, categoric::VariablePtr>;
+
+/**
+ * @throw in case no variable with the passed name exists
+ */
+categoric::VariablePtr find_variable(const VariablesIndex &variables,
+                                     const std::string &name);
+
+/**
+ * @brief adds the passed variable to the index
+ * @throw in case a variable with the same name was already added
+ */
+void add_variable(VariablesIndex &variables,
+                  const categoric::VariablePtr &variable);
+
 struct ImportHelper {
   ImportHelper(Inserters m) : model(m) {}
 
   Inserters model;
 
-  struct TunableCluster {
-    train::FactorExponentialPtr factor;
-    categoric::VariablesSet group_owning_w_to_share;
+  /**
+   * @brief A factor parsed from a model description, ready to be imported.
+   */
+  struct Parsed {
+    factor::ImmutablePtr constant = nullptr;
+    train::FactorExponentialPtr tunable = nullptr;
+    std::optional<categoric::VariablesSet> sharing_group = std::nullopt;
   };
-  std::vector<TunableCluster> cumulated;
-  void importCumulatedTunable() const;
 
-  void importConst(const factor::ImmutablePtr &factor);
+  /**
+   * @brief imports the passed factors, updating the structure of the model
+   * once for every sequence of consecutive factors of the same kind (const or
+   * tunable). Tunable factors sharing their weight are only cumulated, as the
+   * factor owning the weight might come later: they are imported by
+   * importCumulatedTunable().
+   */
+  void import(const std::vector<Parsed> &parsed);
+
+  std::vector<train::FactorsTunableInserter::TunableFactorToAdd> cumulated;
+  void importCumulatedTunable() const;
 
-  void importTunable(const train::FactorExponentialPtr &factor,
-                     const std::optional<categoric::VariablesSet>
-                         &sharing_group = std::nullopt);
+  /**
+   * @brief converts the passed records into factors, by making use of the
+   * specified number of threads. The factors are imported only after having
+   * converted all the records, preserving the order of the records.
+   * @param the records to convert
+   * @param the number of threads to use
+   * @param the predicate converting a single record: Parsed(const Record &).
+   * It should not access the model.
+   * @throw the first exception (in the order of the records) raised by the
+   * predicate
+   */
+  template <typename Record, typename Parse>
+  void importAll(const std::vector<Record> &records, std::size_t threads,
+                 const Parse &parse) {
+    std::vector<Parsed> parsed;
+    parsed.resize(records.size());
+    const auto chunks = categoric::partition_domain(records.size(), threads);
+    std::vector<std::exception_ptr> errors;
+    errors.resize(chunks.size());
+    auto parse_chunk = [&](std::size_t chunk) {
+      try {
+        for (std::size_t k = chunks[chunk].first; k < chunks[chunk].second;
+             ++k) {
+          parsed[k] = parse(records[k]);
+        }
+      } catch (...) {
+        errors[chunk] = std::current_exception();
+      }
+    };
+    if (chunks.size() < 2) {
+      for (std::size_t c = 0; c < chunks.size(); ++c) {
+        parse_chunk(c);
+      }
+    } else {
+      strct::Tasks tasks;
+      for (std::size_t c = 0; c < chunks.size(); ++c) {
+        tasks.emplace_back([&parse_chunk, c](const std::size_t) {
+          parse_chunk(c);
+        });
+      }
+      strct::Pool{chunks.size()}.parallelFor(tasks);
+    }
+    for (const auto &error : errors) {
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    }
+    import(parsed);
+  }
 };
 } // namespace EFG::io
@@ -0,0 +1,145 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#include <EasyFactorGraph/io/bin/Exporter.h>
+
+#include "Streams.h"
+
+namespace EFG::io::bin {
+namespace {
+struct FactorToExport {
+  const factor::Immutable *factor;
+  FactorHeader header;
+};
+
+FactorHeader make_factor_header(const factor::Immutable &factor,
+                                FactorKind kind,
+                                const std::unordered_map<std::string,
+                                                         std::uint64_t> &vars) {
+  const auto &group = factor.function().vars().getVariables();
+  if ((group.size() != 1) && (group.size() != 2)) {
+    throw Error("only unary or binary factor are supported");
+  }
+  FactorHeader result;
+  std::memset(&result, 0, sizeof(FactorHeader));
+  result.kind = kind;
+  result.arity = static_cast<std::uint32_t>(group.size());
+  result.weight = 1.f;
+  result.sharing = NO_SHARING;
+  for (std::size_t k = 0; k < group.size(); ++k) {
+    result.variables[k] = vars.at(group[k]->name());
+  }
+  result.images_count = factor.function().getInfo().totCombinations;
+  return result;
+}
+} // namespace
+
+void Exporter::convert(const std::filesystem::path &file_path,
+                       Getters subject) {
+  auto [state, constGetter, tunableGetter] = subject;
+
+  categoric::VariablesSoup variables;
+  for (const auto &hidden_var : state->getHiddenVariables()) {
+    variables.push_back(hidden_var);
+  }
+  std::vector<EvidenceEntry> evidences;
+  for (const auto &[evidence_var, evidence_val] : state->getEvidences()) {
+    evidences.push_back(
+        EvidenceEntry{variables.size(), static_cast<std::uint64_t>(evidence_val)});
+    variables.push_back(evidence_var);
+  }
+  std::unordered_map<std::string, std::uint64_t> variables_indices;
+  for (std::size_t k = 0; k < variables.size(); ++k) {
+    variables_indices.emplace(variables[k]->name(), k);
+  }
+
+  std::vector<FactorToExport> factors;
+  for (const auto &const_factor : constGetter->getConstFactors()) {
+    const auto *as_exp =
+        dynamic_cast<const factor::FactorExponential *>(const_factor.get());
+    auto &added = factors.emplace_back(FactorToExport{
+        const_factor.get(),
+        make_factor_header(*const_factor,
+                           (as_exp == nullptr) ? FactorKind::CONST
+                                               : FactorKind::CONST_EXPONENTIAL,
+                           variables_indices)});
+    if (as_exp != nullptr) {
+      added.header.weight = as_exp->getWeight();
+    }
+  }
+  if (tunableGetter) {
+    auto add_tunable = [&](const train::FactorExponentialPtr &factor,
+                           std::uint64_t sharing) {
+      auto &added = factors.emplace_back(FactorToExport{
+          factor.get(), make_factor_header(*factor, FactorKind::TUNABLE,
+                                           variables_indices)});
+      added.header.weight = factor->getWeight();
+      added.header.sharing = sharing;
+    };
+    for (const auto &cluster : tunableGetter->getTunableClusters()) {
+      VisitorConst<train::FactorExponentialPtr, train::TunableClusters>{
+          [&](const train::FactorExponentialPtr &factor) {
+            add_tunable(factor, NO_SHARING);
+          },
+          [&](const train::TunableClusters &cluster) {
+            const std::uint64_t owner = factors.size();
+            add_tunable(cluster.front(), NO_SHARING);
+            std::for_each(cluster.begin() + 1, cluster.end(),
+                          [&](const train::FactorExponentialPtr &factor) {
+                            add_tunable(factor, owner);
+                          });
+          }}
+          .visit(cluster);
+    }
+  }
+
+  // compute where the images of each factor will be placed
+  std::uint64_t offset = sizeof(Header);
+  for (const auto &var : variables) {
+    offset += variable_entry_size(*var);
+  }
+  offset += evidences.size() * sizeof(EvidenceEntry);
+  offset += factors.size() * sizeof(FactorHeader);
+  for (auto &[factor, header] : factors) {
+    offset = align(offset, IMAGES_ALIGNMENT);
+    header.images_offset = offset;
+    offset += header.images_count * sizeof(float);
+  }
+
+  Writer writer{file_path};
+  {
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.variables = variables.size();
+    header.evidences = evidences.size();
+    header.factors = factors.size();
+    writer.write(header);
+  }
+  for (const auto &var : variables) {
+    writer.writeVariable(*var);
+  }
+  for (const auto &evidence : evidences) {
+    writer.write(evidence);
+  }
+  for (const auto &[factor, header] : factors) {
+    writer.write(header);
+  }
+  std::vector<float> images;
+  for (const auto &[factor, header] : factors) {
+    writer.padTo(IMAGES_ALIGNMENT);
+    images.clear();
+    factor->function().forEachCombination<false>(
+        [&images](const auto &, float img) { images.push_back(img); });
+    writer.write(reinterpret_cast<const char *>(images.data()),
+                 images.size() * sizeof(float));
+  }
+  writer.close();
+}
+} // namespace EFG::io::bin
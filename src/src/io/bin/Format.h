@@ -0,0 +1,81 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace EFG::io::bin {
+static constexpr char MAGIC[4] = {'E', 'F', 'G', 'B'};
+static constexpr std::uint32_t VERSION = 1;
+// written as is: reading it back differently means the file was generated on
+// a machine with a different endianess
+static constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+static constexpr std::uint64_t SECTION_ALIGNMENT = 8;
+static constexpr std::uint64_t IMAGES_ALIGNMENT = 64;
+
+inline std::uint64_t align(std::uint64_t offset, std::uint64_t alignment) {
+  const std::uint64_t remainder = offset % alignment;
+  return (remainder == 0) ? offset : offset + alignment - remainder;
+}
+
+struct Header {
+  char magic[4];
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint32_t reserved;
+  std::uint64_t variables;
+  std::uint64_t evidences;
+  std::uint64_t factors;
+};
+
+// followed by the name (not null terminated), padded to SECTION_ALIGNMENT
+struct VariableHeader {
+  std::uint64_t size;
+  std::uint64_t name_length;
+};
+
+struct EvidenceEntry {
+  std::uint64_t variable;
+  std::uint64_t value;
+};
+
+enum class FactorKind : std::uint32_t { CONST = 0, CONST_EXPONENTIAL, TUNABLE };
+
+static constexpr std::uint64_t NO_SHARING =
+    std::numeric_limits<std::uint64_t>::max();
+
+struct FactorHeader {
+  FactorKind kind;
+  // only unary and binary factors are supported
+  std::uint32_t arity;
+  float weight;
+  std::uint32_t reserved;
+  // index of the factor owning the weight to share
+  std::uint64_t sharing;
+  std::uint64_t variables[2];
+  // absolute position in the file of the first image
+  std::uint64_t images_offset;
+  std::uint64_t images_count;
+};
+
+static constexpr char TRAIN_SET_MAGIC[4] = {'E', 'F', 'G', 'T'};
+
+// followed by the variables (in the same way they are stored for the models)
+// and then by the rows, starting at a position aligned to IMAGES_ALIGNMENT
+struct TrainSetHeader {
+  char magic[4];
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  // number of bytes used to store every value of the rows
+  std::uint32_t width;
+  std::uint64_t variables;
+  std::uint64_t rows;
+};
+} // namespace EFG::io::bin
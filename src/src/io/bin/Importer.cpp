@@ -0,0 +1,134 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#include <EasyFactorGraph/io/bin/Importer.h>
+
+#include "Streams.h"
+
+namespace EFG::io::bin {
+namespace {
+class AliasingFactor : public factor::Factor {
+public:
+  AliasingFactor(const categoric::Group &vars,
+                 std::shared_ptr<const void> owner, const float *images)
+      : factor::Factor{vars} {
+    functionMutable().aliasDenseImages(std::move(owner), images);
+  }
+};
+
+const float *access_images(const MappedFile &file, const FactorHeader &header,
+                           std::size_t expected_count) {
+  if (header.images_count != expected_count) {
+    throw Error::make("Expected ", std::to_string(expected_count),
+                      " images, while found ",
+                      std::to_string(header.images_count));
+  }
+  if ((header.images_offset % alignof(float) != 0) ||
+      (file.size() < header.images_offset) ||
+      ((file.size() - header.images_offset) / sizeof(float) <
+       header.images_count)) {
+    throw Error{"Images out of the binary model"};
+  }
+  return reinterpret_cast<const float *>(file.data() + header.images_offset);
+}
+} // namespace
+
+std::unordered_map<std::string, std::size_t>
+Importer::convert(Inserters recipient, const std::filesystem::path &file_path) {
+  auto file = std::make_shared<const MappedFile>(file_path);
+  Reader reader{*file};
+
+  const auto header = reader.read<Header>();
+  if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+    throw Error::make(file_path, " is not a binary model");
+  }
+  if (header.byte_order != BYTE_ORDER_MARK) {
+    throw Error::make(file_path,
+                      " was generated on a machine with a different endianess");
+  }
+  if (header.version != VERSION) {
+    throw Error::make(file_path, " has version ",
+                      std::to_string(header.version), " while ",
+                      std::to_string(VERSION), " is supported");
+  }
+
+  // import variables
+  categoric::VariablesSoup variables;
+  categoric::VariablesSet variables_set;
+  for (std::uint64_t k = 0; k < header.variables; ++k) {
+    auto new_var = reader.readVariable();
+    if (!variables_set.emplace(new_var).second) {
+      throw Error::make(new_var->name(),
+                        " is a multiple times specified variable ");
+    }
+    variables.push_back(new_var);
+  }
+  auto get_variable = [&variables](std::uint64_t index) {
+    if (variables.size() <= index) {
+      throw Error{"Inexistent variable"};
+    }
+    return variables[index];
+  };
+
+  std::unordered_map<std::string, std::size_t> evidences;
+  for (std::uint64_t k = 0; k < header.evidences; ++k) {
+    const auto evidence = reader.read<EvidenceEntry>();
+    evidences.emplace(get_variable(evidence.variable)->name(),
+                      static_cast<std::size_t>(evidence.value));
+  }
+
+  // import potentials
+  ImportHelper importer(recipient);
+  std::vector<ImportHelper::Parsed> parsed;
+  parsed.reserve(header.factors);
+  std::vector<categoric::VariablesSet> factors_groups;
+  factors_groups.reserve(header.factors);
+  for (std::uint64_t k = 0; k < header.factors; ++k) {
+    const auto factor_header = reader.read<FactorHeader>();
+    if ((factor_header.arity != 1) && (factor_header.arity != 2)) {
+      throw Error("only unary or binary factor are supported");
+    }
+    categoric::VariablesSoup group;
+    for (std::uint32_t v = 0; v < factor_header.arity; ++v) {
+      group.push_back(get_variable(factor_header.variables[v]));
+    }
+    categoric::Group as_group{group};
+    factors_groups.push_back(as_group.getVariablesSet());
+
+    auto shape = std::make_shared<AliasingFactor>(
+        as_group, file,
+        access_images(*file, factor_header, as_group.size()));
+    switch (factor_header.kind) {
+    case FactorKind::CONST:
+      parsed.push_back(ImportHelper::Parsed{shape});
+      break;
+    case FactorKind::CONST_EXPONENTIAL:
+      parsed.push_back(
+          ImportHelper::Parsed{std::make_shared<factor::FactorExponential>(
+              *shape, factor_header.weight)});
+      break;
+    case FactorKind::TUNABLE: {
+      ImportHelper::Parsed added{
+          nullptr, std::make_shared<factor::FactorExponential>(
+                       *shape, factor_header.weight)};
+      if (factor_header.sharing != NO_SHARING) {
+        if (k <= factor_header.sharing) {
+          throw Error{"Invalid factor to share the weight with"};
+        }
+        added.sharing_group = factors_groups[factor_header.sharing];
+      }
+      parsed.push_back(std::move(added));
+    } break;
+    default:
+      throw Error{"Invalid kind of factor"};
+    }
+  }
+  importer.import(parsed);
+  importer.importCumulatedTunable();
+  return evidences;
+}
+} // namespace EFG::io::bin
@@ -0,0 +1,67 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#include "MappedFile.h"
+
+#include <EasyFactorGraph/Error.h>
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace EFG::io::bin {
+#ifdef _WIN32
+MappedFile::MappedFile(const std::filesystem::path &file_path) {
+  std::ifstream stream{file_path, std::ios::binary};
+  if (!stream.is_open()) {
+    throw Error::make(file_path, " is a non valid file path");
+  }
+  size_ = static_cast<std::size_t>(std::filesystem::file_size(file_path));
+  buffer.resize(size_ / sizeof(std::uint64_t) + 1);
+  stream.read(reinterpret_cast<char *>(buffer.data()), size_);
+  data_ = reinterpret_cast<const char *>(buffer.data());
+}
+
+MappedFile::~MappedFile() = default;
+#else
+MappedFile::MappedFile(const std::filesystem::path &file_path) {
+  const int descriptor = ::open(file_path.c_str(), O_RDONLY);
+  if (descriptor < 0) {
+    throw Error::make(file_path, " is a non valid file path");
+  }
+  struct stat info;
+  if (::fstat(descriptor, &info) != 0) {
+    ::close(descriptor);
+    throw Error::make(file_path, " can't be inspected");
+  }
+  size_ = static_cast<std::size_t>(info.st_size);
+  if (size_ == 0) {
+    ::close(descriptor);
+    return;
+  }
+  void *mapped =
+      ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+  // the mapping remains valid after closing the descriptor
+  ::close(descriptor);
+  if (mapped == MAP_FAILED) {
+    throw Error::make(file_path, " can't be memory mapped");
+  }
+  data_ = static_cast<const char *>(mapped);
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    ::munmap(const_cast<char *>(data_), size_);
+  }
+}
+#endif
+} // namespace EFG::io::bin
@@ -0,0 +1,41 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace EFG::io::bin {
+/**
+ * @brief Read only view of an entire file. On POSIX systems the file is memory
+ * mapped, while on the other ones it is read into an heap buffer.
+ * The beginning of the view is always aligned at least to 8 bytes.
+ */
+class MappedFile {
+public:
+  /**
+   * @throw in case the file can't be opened or mapped
+   */
+  MappedFile(const std::filesystem::path &file_path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  const char *data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+private:
+  const char *data_ = nullptr;
+  std::size_t size_ = 0;
+#ifdef _WIN32
+  std::vector<std::uint64_t> buffer;
+#endif
+};
+} // namespace EFG::io::bin
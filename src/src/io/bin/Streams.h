@@ -0,0 +1,109 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#pragma once
+
+#include <EasyFactorGraph/categoric/Variable.h>
+
+#include "../Utils.h"
+#include "Format.h"
+#include "MappedFile.h"
+
+#include <cstring>
+
+namespace EFG::io::bin {
+class Reader {
+public:
+  Reader(const MappedFile &file) : file{file} {}
+
+  template <typename T> T read() {
+    T result;
+    std::memcpy(&result, advance(sizeof(T)), sizeof(T));
+    return result;
+  }
+
+  const char *advance(std::uint64_t size) {
+    if (file.size() - position < size) {
+      throw Error{"Unexpected end of binary file"};
+    }
+    const char *result = file.data() + position;
+    position += size;
+    return result;
+  }
+
+  void skipPadding(std::uint64_t alignment) {
+    advance(align(position, alignment) - position);
+  }
+
+  // reads a VariableHeader, followed by the name
+  categoric::VariablePtr readVariable() {
+    const auto var_header = read<VariableHeader>();
+    std::string name{advance(var_header.name_length), var_header.name_length};
+    skipPadding(SECTION_ALIGNMENT);
+    return categoric::make_variable(var_header.size, name);
+  }
+
+private:
+  const MappedFile &file;
+  std::uint64_t position = 0;
+};
+
+class Writer {
+public:
+  Writer(const std::filesystem::path &file_path)
+      : file_path{file_path}, stream{file_path, std::ios::binary} {
+    detail::check_stream(stream, file_path);
+  }
+
+  template <typename T> void write(const T &subject) {
+    write(reinterpret_cast<const char *>(&subject), sizeof(T));
+  }
+
+  void write(const char *buffer, std::size_t size) {
+    stream.write(buffer, size);
+    checkWritten();
+    position += size;
+  }
+
+  void padTo(std::uint64_t alignment) {
+    static const char zeros[IMAGES_ALIGNMENT] = {};
+    write(zeros, align(position, alignment) - position);
+  }
+
+  // writes a VariableHeader, followed by the name
+  void writeVariable(const categoric::Variable &var) {
+    write(VariableHeader{var.size(), var.name().size()});
+    write(var.name().data(), var.name().size());
+    padTo(SECTION_ALIGNMENT);
+  }
+
+  /**
+   * @brief flushes and closes the file. To call once everything was written,
+   * as failures happening while flushing can't be reported by the destructor.
+   * @throw if something written so far could not reach the file
+   */
+  void close() {
+    stream.close();
+    checkWritten();
+  }
+
+private:
+  void checkWritten() const {
+    if (!stream) {
+      throw Error::make(file_path, " could not be entirely written");
+    }
+  }
+
+  std::filesystem::path file_path;
+  std::ofstream stream;
+  std::uint64_t position = 0;
+};
+
+inline std::uint64_t variable_entry_size(const categoric::Variable &var) {
+  return sizeof(VariableHeader) + align(var.name().size(), SECTION_ALIGNMENT);
+}
+} // namespace EFG::io::bin
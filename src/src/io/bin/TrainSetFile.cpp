@@ -0,0 +1,180 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#include <EasyFactorGraph/io/bin/TrainSetFile.h>
+
+#include "Streams.h"
+
+#include <algorithm>
+
+namespace EFG::io::bin {
+namespace {
+void check_header(const TrainSetHeader &header,
+                  const std::filesystem::path &file_path) {
+  if (std::memcmp(header.magic, TRAIN_SET_MAGIC, sizeof(TRAIN_SET_MAGIC)) !=
+      0) {
+    throw Error::make(file_path, " is not a binary train set");
+  }
+  if (header.byte_order != BYTE_ORDER_MARK) {
+    throw Error::make(file_path,
+                      " was generated on a machine with a different endianess");
+  }
+  if (header.version != VERSION) {
+    throw Error::make(file_path, " has version ",
+                      std::to_string(header.version), " while ",
+                      std::to_string(VERSION), " is supported");
+  }
+}
+} // namespace
+
+void export_train_set(const std::filesystem::path &file_path,
+                      const categoric::VariablesSoup &variables,
+                      const categoric::CombinationMatrix &combinations) {
+  if (variables.size() != combinations.columns()) {
+    throw Error::make(std::to_string(variables.size()),
+                      "variables can't describe combinations of size",
+                      std::to_string(combinations.columns()));
+  }
+  for (const auto combination : combinations) {
+    for (std::size_t k = 0; k < variables.size(); ++k) {
+      if (variables[k]->size() <= combination[k]) {
+        throw Error::make(combination[k],
+                          "is an invalid value for variable",
+                          variables[k]->name());
+      }
+    }
+  }
+
+  Writer writer{file_path};
+  {
+    TrainSetHeader header;
+    std::memset(&header, 0, sizeof(TrainSetHeader));
+    std::memcpy(header.magic, TRAIN_SET_MAGIC, sizeof(TRAIN_SET_MAGIC));
+    header.version = VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.width = static_cast<std::uint32_t>(combinations.width());
+    header.variables = variables.size();
+    header.rows = combinations.size();
+    writer.write(header);
+  }
+  for (const auto &var : variables) {
+    writer.writeVariable(*var);
+  }
+  writer.padTo(IMAGES_ALIGNMENT);
+  const auto rows = combinations.bytes();
+  writer.write(rows.data(), rows.size());
+  writer.close();
+}
+
+TrainSetFile import_train_set(const std::filesystem::path &file_path) {
+  auto file = std::make_shared<const MappedFile>(file_path);
+  Reader reader{*file};
+
+  const auto header = reader.read<TrainSetHeader>();
+  check_header(header, file_path);
+
+  categoric::VariablesSoup variables;
+  categoric::VariablesSet variables_set;
+  for (std::uint64_t k = 0; k < header.variables; ++k) {
+    auto new_var = reader.readVariable();
+    if (!variables_set.emplace(new_var).second) {
+      throw Error::make(new_var->name(),
+                        " is a multiple times specified variable ");
+    }
+    variables.push_back(new_var);
+  }
+
+  reader.skipPadding(IMAGES_ALIGNMENT);
+  const std::uint64_t row_size = header.variables * header.width;
+  if ((row_size != 0) && (header.rows > file->size() / row_size)) {
+    throw Error{"Rows out of the binary train set"};
+  }
+  const char *rows = reader.advance(header.rows * row_size);
+  categoric::CombinationMatrix combinations{
+      file, reinterpret_cast<const std::uint8_t *>(rows), header.rows,
+      header.variables, header.width};
+  return TrainSetFile{std::move(variables),
+                      train::TrainSet{std::move(combinations)}};
+}
+
+void convert_train_set(const std::filesystem::path &text_file_path,
+                       const categoric::VariablesSoup &variables,
+                       const std::filesystem::path &file_path) {
+  export_train_set(file_path, variables, import_combinations(text_file_path));
+}
+
+TrainSetFileSource::TrainSetFileSource(const std::filesystem::path &file_path,
+                                       std::size_t chunk_rows)
+    : stream{file_path, std::ios::binary}, chunk_rows{chunk_rows} {
+  detail::check_stream(stream, file_path);
+  if (chunk_rows == 0) {
+    throw Error{"chunks should have at least 1 row"};
+  }
+  auto read = [this](char *recipient, std::size_t size) {
+    if (!stream.read(recipient, size)) {
+      throw Error{"Unexpected end of binary file"};
+    }
+  };
+  TrainSetHeader header;
+  read(reinterpret_cast<char *>(&header), sizeof(TrainSetHeader));
+  check_header(header, file_path);
+  std::uint64_t position = sizeof(TrainSetHeader);
+  categoric::VariablesSet variables_set;
+  for (std::uint64_t k = 0; k < header.variables; ++k) {
+    VariableHeader var_header;
+    read(reinterpret_cast<char *>(&var_header), sizeof(VariableHeader));
+    std::string name(align(var_header.name_length, SECTION_ALIGNMENT), ' ');
+    read(name.data(), name.size());
+    name.resize(var_header.name_length);
+    auto new_var = categoric::make_variable(var_header.size, name);
+    position += variable_entry_size(*new_var);
+    if (!variables_set.emplace(new_var).second) {
+      throw Error::make(new_var->name(),
+                        " is a multiple times specified variable ");
+    }
+    variables.push_back(new_var);
+  }
+  if ((header.width != 1) && (header.width != 2) && (header.width != 4) &&
+      (header.width != 8)) {
+    throw Error::make(header.width, "is an invalid width for the values");
+  }
+  width = header.width;
+  rows = header.rows;
+  rows_offset = static_cast<std::streamoff>(align(position, IMAGES_ALIGNMENT));
+  const std::uint64_t file_size = std::filesystem::file_size(file_path);
+  const std::uint64_t row_size = variables.size() * width;
+  if ((file_size < static_cast<std::uint64_t>(rows_offset)) ||
+      ((row_size != 0) &&
+       ((file_size - rows_offset) / row_size < header.rows))) {
+    throw Error{"Rows out of the binary train set"};
+  }
+  rewind();
+}
+
+std::optional<categoric::CombinationMatrix> TrainSetFileSource::nextChunk() {
+  if (next_row == rows) {
+    return std::nullopt;
+  }
+  const std::size_t chunk_size = std::min(chunk_rows, rows - next_row);
+  auto buffer = std::make_shared<std::vector<std::uint8_t>>(
+      chunk_size * variables.size() * width);
+  if (!stream.read(reinterpret_cast<char *>(buffer->data()),
+                   buffer->size())) {
+    throw Error{"Unexpected end of binary file"};
+  }
+  next_row += chunk_size;
+  const std::uint8_t *data = buffer->data();
+  return categoric::CombinationMatrix{std::move(buffer), data, chunk_size,
+                                      variables.size(), width};
+}
+
+void TrainSetFileSource::rewind() {
+  stream.clear();
+  stream.seekg(rows_offset);
+  next_row = 0;
+}
+} // namespace EFG::io::bin
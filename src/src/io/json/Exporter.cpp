@@ -14,8 +14,17 @@
 namespace EFG::io::json {
 void Exporter::exportToFile(const nlohmann::json &source,
                             const std::filesystem::path &out) {
-  useOutStrem(out,
-              [&source](std::ofstream &stream) { stream << source.dump(); });
+  // the variables are written before anything else, allowing the streaming
+  // importer to create the factors while parsing them
+  useOutStrem(out, [&source](std::ofstream &stream) {
+    stream << "{\"Variables\":" << source.at("Variables").dump();
+    for (const auto &[key, value] : source.items()) {
+      if (key != "Variables") {
+        stream << ',' << nlohmann::json(key).dump() << ':' << value.dump();
+      }
+    }
+    stream << '}';
+  });
 }
 
 namespace {
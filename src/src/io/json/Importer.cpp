@@ -11,16 +11,9 @@
 
 #include "../Utils.h"
 
-namespace EFG::io::json {
-nlohmann::json
-Importer::importJsonFromFile(const std::filesystem::path &file_path) {
-  nlohmann::json res;
-  useInStrem(file_path, [&res](std::ifstream &stream) {
-    res = nlohmann::json::parse(stream);
-  });
-  return res;
-}
+#include <optional>
 
+namespace EFG::io::json {
 namespace {
 const nlohmann::json *try_access(const nlohmann::json &subject,
                                  const std::string &name) {
@@ -43,23 +36,11 @@ std::string to_string(const nlohmann::json &subject) {
   throw Error{"Expected a string"};
 }
 
-categoric::VariablePtr findVariable(const std::string &name,
-                                    const categoric::VariablesSet &variables) {
-  const auto itV = std::find_if(variables.begin(), variables.end(),
-                                [&name](const categoric::VariablePtr &var) {
-                                  return var->name() == name;
-                                });
-  if (itV == variables.end()) {
-    throw Error("Inexistent variable");
-  }
-  return *itV;
-}
-
 categoric::Group importGroup(const nlohmann::json &subject,
-                             const categoric::VariablesSet &variables) {
+                             const VariablesIndex &variables) {
   categoric::VariablesSoup group;
   for (const auto &var : subject) {
-    group.push_back(findVariable(to_string(var), variables));
+    group.push_back(find_variable(variables, to_string(var)));
   }
   if ((group.size() != 1) && (group.size() != 2)) {
     throw Error("only unary or binary factor are supported");
@@ -69,7 +50,7 @@ categoric::Group importGroup(const nlohmann::json &subject,
 
 std::shared_ptr<factor::Factor>
 importFactor(const nlohmann::json &subject,
-             const categoric::VariablesSet &variables) {
+             const VariablesIndex &variables) {
   auto group = importGroup(access(subject, "Variables"), variables);
 
   const auto *corr = try_access(subject, "Correlation");
@@ -103,46 +84,41 @@ importFactor(const nlohmann::json &subject,
   return result;
 }
 
-void importPotential(const nlohmann::json &subject,
-                     const categoric::VariablesSet &variables,
-                     ImportHelper &importer) {
+ImportHelper::Parsed parsePotential(const nlohmann::json &subject,
+                                    const VariablesIndex &variables) {
   auto shape = importFactor(subject, variables);
   const auto *w = try_access(subject, "weight");
   if (nullptr == w) {
-    importer.importConst(shape);
-    return;
+    return ImportHelper::Parsed{shape};
   }
 
   auto factor = std::make_shared<factor::FactorExponential>(
       *shape, static_cast<float>(std::atof(to_string(*w).c_str())));
   const auto *tunab = try_access(subject, "tunability");
   if ((nullptr != tunab) && (to_string(*tunab) == "Y")) {
+    ImportHelper::Parsed result{nullptr, factor};
     const auto *share_tag = try_access(subject, "Share");
-    if (nullptr == share_tag) {
-      importer.importTunable(factor);
-    } else {
-      auto group = importGroup(*share_tag, variables).getVariablesSet();
-      importer.importTunable(factor, group);
+    if (nullptr != share_tag) {
+      result.sharing_group =
+          importGroup(*share_tag, variables).getVariablesSet();
     }
-    return;
+    return result;
   }
-  importer.importConst(factor);
+  return ImportHelper::Parsed{factor};
 }
 } // namespace
 
 std::unordered_map<std::string, std::size_t>
-Importer::convert(Inserters recipient, const nlohmann::json &source) {
+Importer::convert(Inserters recipient, const nlohmann::json &source,
+                  std::size_t threads) {
   // import variables
-  categoric::VariablesSet variables;
+  VariablesIndex variables;
   std::unordered_map<std::string, std::size_t> evidences;
   for (const auto &var : source["Variables"]) {
     const auto name = to_string(access(var, "name"));
     const auto size = to_string(access(var, "Size"));
     auto new_var = categoric::make_variable(std::atoi(size.c_str()), name);
-    if (variables.find(new_var) != variables.end()) {
-      throw Error::make(name, " is a multiple times specified variable ");
-    }
-    variables.emplace(new_var);
+    add_variable(variables, new_var);
     const auto *obs_flag = try_access(var, "evidence");
     if (nullptr != obs_flag) {
       const std::size_t val =
@@ -151,13 +127,335 @@ Importer::convert(Inserters recipient, const nlohmann::json &source) {
     }
   }
   // import potentials
-  ImportHelper importer(recipient);
+  std::vector<const nlohmann::json *> potentials;
   for (const auto &factor : source["Potentials"]) {
-    importPotential(factor, variables, importer);
+    potentials.push_back(&factor);
   }
+  ImportHelper importer(recipient);
+  importer.importAll(potentials, threads,
+                     [&variables](const nlohmann::json *factor) {
+                       return parsePotential(*factor, variables);
+                     });
   importer.importCumulatedTunable();
   return evidences;
 }
+
+namespace {
+std::size_t to_size(const std::string &subject) {
+  return static_cast<std::size_t>(std::strtoul(subject.c_str(), nullptr, 10));
+}
+
+float to_float(const std::string &subject) {
+  return std::strtof(subject.c_str(), nullptr);
+}
+
+struct VariableRecord {
+  std::optional<std::string> name;
+  std::optional<std::string> size;
+  std::optional<std::string> evidence;
+};
+
+struct PotentialRecord {
+  std::vector<std::string> variables;
+  std::optional<std::vector<std::string>> share;
+  std::optional<std::string> correlation;
+  std::optional<std::string> weight;
+  std::optional<std::string> tunability;
+
+  // when using a single thread, the factor is created by the first
+  // combination parsed after knowing the variables, filling it with the
+  // combinations parsed from that moment on
+  std::shared_ptr<factor::Factor> factor;
+  // combinations to set when building the factor, stored one after the other
+  std::vector<std::size_t> pending_combinations;
+  std::vector<float> pending_images;
+};
+
+/**
+ * @brief Builds the model while receiving the SAX events of the json parser.
+ * The position inside the json is tracked by the nesting depth, together with
+ * the last key found at the levels of interest:
+ * - depth 1: the section ("Variables" or "Potentials")
+ * - depth 3: the field of a variable or of a potential
+ * - depth 5: the field of an element of "Distr_val"
+ * Anything else is skipped.
+ */
+class StreamingConverter : public nlohmann::json_sax<nlohmann::json> {
+public:
+  StreamingConverter(Inserters recipient, std::size_t threads)
+      : importer{recipient}, threads{threads} {}
+
+  std::unordered_map<std::string, std::size_t> evidences;
+
+  bool null() override { return true; }
+  bool boolean(bool) override { return true; }
+  bool number_integer(number_integer_t val) override {
+    return scalar(std::to_string(val));
+  }
+  bool number_unsigned(number_unsigned_t val) override {
+    return scalar(std::to_string(val));
+  }
+  bool number_float(number_float_t, const string_t &raw) override {
+    return scalar(raw);
+  }
+  bool string(string_t &val) override { return scalar(val); }
+  bool binary(binary_t &) override { return true; }
+
+  bool key(string_t &val) override {
+    switch (depth) {
+    case 1:
+      section = val;
+      break;
+    case 3:
+      field = val;
+      break;
+    case 5:
+      entry_field = val;
+      break;
+    }
+    return true;
+  }
+
+  bool start_object(std::size_t) override {
+    ++depth;
+    if (depth == 3 && section == VARIABLES) {
+      variable = VariableRecord{};
+    } else if (depth == 3 && section == POTENTIALS) {
+      potential = PotentialRecord{};
+    } else if (depth == 5 && inPotentialField(DISTR_VAL)) {
+      entry_combination.clear();
+      entry_image.reset();
+    }
+    return true;
+  }
+
+  bool end_object() override {
+    if (depth == 1) {
+      importer.import(parsed_potentials);
+      parsed_potentials.clear();
+      importer.importAll(deferred_potentials, threads,
+                         [this](const PotentialRecord &subject) {
+                           return parsePotential(subject);
+                         });
+      deferred_potentials.clear();
+      importer.importCumulatedTunable();
+    } else if (depth == 3 && section == VARIABLES) {
+      importVariable();
+    } else if (depth == 3 && section == POTENTIALS) {
+      if (variables_parsed && (threads < 2)) {
+        parsed_potentials.push_back(parsePotential(potential));
+      } else {
+        deferred_potentials.emplace_back(std::move(potential));
+      }
+    } else if (depth == 5 && inPotentialField(DISTR_VAL)) {
+      addCombination();
+    }
+    --depth;
+    return true;
+  }
+
+  bool start_array(std::size_t) override {
+    ++depth;
+    if (depth == 4 && inPotentialField(SHARE)) {
+      potential.share.emplace();
+    }
+    return true;
+  }
+
+  bool end_array() override {
+    if (depth == 2 && section == VARIABLES) {
+      variables_parsed = true;
+    }
+    --depth;
+    return true;
+  }
+
+  bool parse_error(std::size_t position, const std::string &,
+                   const nlohmann::detail::exception &ex) override {
+    throw Error::make("Invalid json at position ", std::to_string(position),
+                      ": ", ex.what());
+  }
+
+private:
+  static const inline std::string VARIABLES = "Variables";
+  static const inline std::string POTENTIALS = "Potentials";
+  static const inline std::string SHARE = "Share";
+  static const inline std::string DISTR_VAL = "Distr_val";
+
+  bool inPotentialField(const std::string &name) const {
+    return (section == POTENTIALS) && (field == name);
+  }
+
+  bool scalar(const std::string &val) {
+    if (depth == 3 && section == VARIABLES) {
+      if (field == "name") {
+        variable.name = val;
+      } else if (field == "Size") {
+        variable.size = val;
+      } else if (field == "evidence") {
+        variable.evidence = val;
+      }
+    } else if (depth == 3 && section == POTENTIALS) {
+      if (field == "Correlation") {
+        potential.correlation = val;
+      } else if (field == "weight") {
+        potential.weight = val;
+      } else if (field == "tunability") {
+        potential.tunability = val;
+      }
+    } else if (depth == 4 && inPotentialField(VARIABLES)) {
+      potential.variables.push_back(val);
+    } else if (depth == 4 && inPotentialField(SHARE)) {
+      potential.share->push_back(val);
+    } else if (depth == 5 && inPotentialField(DISTR_VAL) &&
+               entry_field == "D") {
+      entry_image = to_float(val);
+    } else if (depth == 6 && inPotentialField(DISTR_VAL) &&
+               entry_field == "v") {
+      entry_combination.push_back(to_size(val));
+    }
+    return true;
+  }
+
+  void importVariable() {
+    if (!variable.name.has_value()) {
+      throw Error{"name is inexistent"};
+    }
+    if (!variable.size.has_value()) {
+      throw Error{"Size is inexistent"};
+    }
+    const auto &name = variable.name.value();
+    auto new_var =
+        categoric::make_variable(to_size(variable.size.value()), name);
+    add_variable(variables, new_var);
+    if (variable.evidence.has_value()) {
+      evidences.emplace(name, to_size(variable.evidence.value()));
+    }
+  }
+
+  categoric::Group makeGroup(const std::vector<std::string> &names) const {
+    categoric::VariablesSoup group;
+    for (const auto &name : names) {
+      group.push_back(find_variable(variables, name));
+    }
+    if ((group.size() != 1) && (group.size() != 2)) {
+      throw Error("only unary or binary factor are supported");
+    }
+    return categoric::Group{group};
+  }
+
+  std::shared_ptr<factor::Factor>
+  makeFactor(const PotentialRecord &subject) const {
+    auto result =
+        std::make_shared<factor::Factor>(makeGroup(subject.variables));
+    const std::size_t arity = subject.variables.size();
+    if (subject.pending_combinations.size() !=
+        arity * subject.pending_images.size()) {
+      throw Error{"Invalid combination"};
+    }
+    std::vector<std::size_t> comb;
+    auto comb_it = subject.pending_combinations.begin();
+    for (float img : subject.pending_images) {
+      comb.assign(comb_it, comb_it + arity);
+      result->set(comb, img);
+      comb_it += arity;
+    }
+    return result;
+  }
+
+  // Factors are built by the workers when using many threads. Correlated
+  // factors are never built from the combinations.
+  bool buildsWhileParsing() const {
+    return variables_parsed && (threads < 2) && !potential.variables.empty() &&
+           !potential.correlation.has_value();
+  }
+
+  void addCombination() {
+    if (!entry_image.has_value()) {
+      throw Error{"D is inexistent"};
+    }
+    if (!potential.factor && buildsWhileParsing()) {
+      potential.factor = makeFactor(potential);
+      potential.pending_combinations = std::vector<std::size_t>{};
+      potential.pending_images = std::vector<float>{};
+    }
+    if (potential.factor) {
+      potential.factor->set(entry_combination, entry_image.value());
+      return;
+    }
+    potential.pending_combinations.insert(potential.pending_combinations.end(),
+                                          entry_combination.begin(),
+                                          entry_combination.end());
+    potential.pending_images.push_back(entry_image.value());
+  }
+
+  ImportHelper::Parsed parsePotential(const PotentialRecord &subject) const {
+    std::shared_ptr<factor::Factor> shape;
+    if (subject.correlation.has_value()) {
+      const auto &corr = subject.correlation.value();
+      auto group = makeGroup(subject.variables);
+      if (corr == "T") {
+        shape = std::make_shared<factor::Factor>(
+            group, factor::Factor::SimplyCorrelatedTag{});
+      } else if (corr == "F") {
+        shape = std::make_shared<factor::Factor>(
+            group, factor::Factor::SimplyAntiCorrelatedTag{});
+      } else {
+        throw Error("invalid option for Correlation");
+      }
+    } else {
+      shape = subject.factor ? subject.factor : makeFactor(subject);
+    }
+
+    if (!subject.weight.has_value()) {
+      return ImportHelper::Parsed{shape};
+    }
+    auto factor = std::make_shared<factor::FactorExponential>(
+        *shape, to_float(subject.weight.value()));
+    if (subject.tunability.has_value() && subject.tunability.value() == "Y") {
+      ImportHelper::Parsed result{nullptr, factor};
+      if (subject.share.has_value()) {
+        result.sharing_group =
+            makeGroup(subject.share.value()).getVariablesSet();
+      }
+      return result;
+    }
+    return ImportHelper::Parsed{factor};
+  }
+
+  ImportHelper importer;
+  const std::size_t threads;
+
+  std::size_t depth = 0;
+  std::string section;
+  std::string field;
+  std::string entry_field;
+
+  VariablesIndex variables;
+  bool variables_parsed = false;
+
+  VariableRecord variable;
+  PotentialRecord potential;
+  // factors are inserted into the model all together, at the end of the parsing
+  std::vector<ImportHelper::Parsed> parsed_potentials;
+  // potentials found before the variables, or all the potentials when using
+  // many threads
+  std::vector<PotentialRecord> deferred_potentials;
+
+  std::vector<std::size_t> entry_combination;
+  std::optional<float> entry_image;
+};
+} // namespace
+
+std::unordered_map<std::string, std::size_t>
+Importer::convert(Inserters recipient, const std::filesystem::path &file_path,
+                  std::size_t threads) {
+  StreamingConverter converter{recipient, threads};
+  useInStrem(file_path, [&converter](std::ifstream &stream) {
+    nlohmann::json::sax_parse(stream, &converter);
+  });
+  return std::move(converter.evidences);
+}
 } // namespace EFG::io::json
 
 #endif
@@ -42,24 +42,12 @@ void for_each_key(const std::unordered_multimap<K, V> &subject, const K &key,
   }
 }
 
-categoric::VariablePtr findVariable(const std::string &name,
-                                    const categoric::VariablesSet &variables) {
-  const auto itV = std::find_if(variables.begin(), variables.end(),
-                                [&name](const categoric::VariablePtr &var) {
-                                  return var->name() == name;
-                                });
-  if (itV == variables.end()) {
-    throw Error("Inexistent variable");
-  }
-  return *itV;
-}
-
 categoric::Group importGroup(const xmlPrs::Tag &tag,
-                             const categoric::VariablesSet &variables) {
+                             const VariablesIndex &variables) {
   categoric::VariablesSoup group;
   for_each_key(tag.getAttributes(), xmlPrs::Name{"var"},
                [&variables, &group](const std::string &name) {
-                 group.push_back(findVariable(name, variables));
+                 group.push_back(find_variable(variables, name));
                });
   if ((group.size() != 1) && (group.size() != 2)) {
     throw Error("only unary or binary factor are supported");
@@ -69,7 +57,7 @@ categoric::Group importGroup(const xmlPrs::Tag &tag,
 
 std::shared_ptr<factor::Factor>
 importFactor(const std::string &prefix, const xmlPrs::Tag &tag,
-             const categoric::VariablesSet &variables) {
+             const VariablesIndex &variables) {
   auto group = importGroup(tag, variables);
 
   const auto *corr = try_access_attribute(tag, "Correlation");
@@ -112,36 +100,34 @@ importFactor(const std::string &prefix, const xmlPrs::Tag &tag,
   return result;
 }
 
-void importPotential(const std::string &prefix, const xmlPrs::Tag &tag,
-                     const categoric::VariablesSet &variables,
-                     ImportHelper &importer) {
+ImportHelper::Parsed parsePotential(const std::string &prefix,
+                                    const xmlPrs::Tag &tag,
+                                    const VariablesIndex &variables) {
   auto shape = importFactor(prefix, tag, variables);
   const auto *w = try_access_attribute(tag, "weight");
   if (nullptr == w) {
-    importer.importConst(shape);
-    return;
+    return ImportHelper::Parsed{shape};
   }
 
   auto factor = std::make_shared<factor::FactorExponential>(
       *shape, static_cast<float>(std::atof(w->c_str())));
   const auto *tunab = try_access_attribute(tag, "tunability");
   if ((nullptr != tunab) && (*tunab == "Y")) {
+    ImportHelper::Parsed result{nullptr, factor};
     auto share_tag_it = tag.getNested().find("Share");
-    if (share_tag_it == tag.getNested().end()) {
-      importer.importTunable(factor);
-    } else {
-      auto group =
+    if (share_tag_it != tag.getNested().end()) {
+      result.sharing_group =
           importGroup(*share_tag_it->second, variables).getVariablesSet();
-      importer.importTunable(factor, group);
     }
-    return;
+    return result;
   }
-  importer.importConst(factor);
+  return ImportHelper::Parsed{factor};
 }
 } // namespace
 
 std::unordered_map<std::string, std::size_t>
-Importer::convert(Inserters subject, const std::filesystem::path &file_path) {
+Importer::convert(Inserters subject, const std::filesystem::path &file_path,
+                  std::size_t threads) {
   auto maybe_parsed_root = xmlPrs::parse_xml(file_path.string());
   auto maybe_parsed_error = std::get_if<xmlPrs::Error>(&maybe_parsed_root);
   if (nullptr != maybe_parsed_error) {
@@ -149,7 +135,7 @@ Importer::convert(Inserters subject, const std::filesystem::path &file_path) {
   }
   const auto &parsed_root = std::get<xmlPrs::Root>(maybe_parsed_root);
   // import variables
-  categoric::VariablesSet variables;
+  VariablesIndex variables;
   std::unordered_map<std::string, std::size_t> evidences;
   for_each_key(
       parsed_root.getNested(), xmlPrs::Name{"Variable"},
@@ -157,10 +143,7 @@ Importer::convert(Inserters subject, const std::filesystem::path &file_path) {
         const auto &name = access_attribute(*var, "name");
         const auto &size = access_attribute(*var, "Size");
         auto new_var = categoric::make_variable(std::atoi(size.c_str()), name);
-        if (variables.find(new_var) != variables.end()) {
-          throw Error::make(name, " is a multiple times specified variable ");
-        }
-        variables.emplace(new_var);
+        add_variable(variables, new_var);
         const auto *obs_flag = try_access_attribute(*var, "evidence");
         if (nullptr != obs_flag) {
           const std::size_t val =
@@ -169,12 +152,17 @@ Importer::convert(Inserters subject, const std::filesystem::path &file_path) {
         }
       });
   // import potentials
-  ImportHelper importer{subject};
+  std::vector<const xmlPrs::Tag *> potentials;
   for_each_key(parsed_root.getNested(), xmlPrs::Name{"Potential"},
-               [&](const xmlPrs::TagPtr &factor) {
-                 importPotential(file_path.parent_path().string(), *factor, variables,
-                                 importer);
+               [&potentials](const xmlPrs::TagPtr &factor) {
+                 potentials.push_back(factor.get());
                });
+  ImportHelper importer{subject};
+  const auto prefix = file_path.parent_path().string();
+  importer.importAll(potentials, threads,
+                     [&prefix, &variables](const xmlPrs::Tag *factor) {
+                       return parsePotential(prefix, *factor, variables);
+                     });
   importer.importCumulatedTunable();
   return evidences;
 }
@@ -6,13 +6,15 @@
  **/
 
 #include <EasyFactorGraph/Error.h>
-#include <EasyFactorGraph/categoric/GroupRange.h>
+#include <EasyFactorGraph/categoric/Odometer.h>
 #include <EasyFactorGraph/model/ConditionalRandomField.h>
 #include <EasyFactorGraph/trainable/tuners/TunerVisitor.h>
 
 #include "HiddenObservedTuner.h"
 
 #include <algorithm>
+#include <exception>
+#include <unordered_map>
 #include <math.h>
 
 namespace EFG::model {
@@ -57,9 +59,7 @@ void ConditionalRandomField::absorb(const SourceStructure &source, bool copy) {
   const auto &const_factors = source.factors_structure->getConstFactors();
   absorbConstFactors(const_factors.begin(), const_factors.end(), copy);
   absorbTunableClusters(*source.factors_tunable_structure, copy);
-  for (const auto &[var, val] : evidences) {
-    setEvidence(findVariable(var->name()), val);
-  }
+  EvidenceSetter::setEvidences(evidences);
   // replace tuners of factors connected to an evidence
   for (auto &tuner : tuners) {
     train::visitTuner(
@@ -125,11 +125,13 @@ void ConditionalRandomField::setEvidences(
     throw Error::make("Expected ", std::to_string(state.evidences.size()),
                       " evidences, but got instead ", values.size());
   }
+  strct::Evidences evidences;
   std::size_t k = 0;
   for (const auto &[var, val] : state.evidences) {
-    setEvidence(var, values[k]);
+    evidences.emplace(var, values[k]);
     ++k;
   }
+  EvidenceSetter::setEvidences(evidences);
 }
 
 std::vector<float> ConditionalRandomField::getWeightsGradient_(
@@ -150,41 +152,111 @@ std::vector<float> ConditionalRandomField::getWeightsGradient_(
     getPool().parallelFor(tasks);
   }
   // compute beta part
-  std::vector<float> betas;
+  const float coeff = 1.f / static_cast<float>(train_set_combinations.size());
+  std::vector<float> betas(tuners.size(), 0);
+  EvidencesPositions evidences_positions;
   {
-    betas.reserve(tuners.size());
-    for (std::size_t k = 0; k < tuners.size(); ++k) {
-      betas.push_back(0);
-    }
-    float coeff = 1.f / static_cast<float>(train_set_combinations.size());
-    strct::Tasks tasks;
-    for (std::size_t t = 0; t < this->tuners.size(); ++t) {
-      tasks.emplace_back([&receiver = betas[t], &tuner = tuners[t],
-                          &coeff](const std::size_t) {
-        receiver += coeff * tuner->getGradientBeta();
-      });
+    std::size_t var_pos = 0;
+    for (const auto &[var, val] : state().evidences) {
+      evidences_positions.emplace_back(var, evidence_vars_positions[var_pos]);
+      ++var_pos;
     }
+  }
+  // samples having the same evidence values have the same betas: the belief
+  // is propagated only once for each distinct evidence values
+  std::vector<EvidencesBucket> buckets;
+  {
+    std::unordered_map<std::vector<std::size_t>, std::size_t,
+                       train::CombinationHasher>
+        buckets_positions;
+    std::vector<std::size_t> values(evidences_positions.size());
     train_set_combinations.forEachSample(
-        [this, &tasks](const auto &combination) {
-          {
-            std::size_t var_pos = 0;
-            for (auto &[var, val] : this->state().evidences) {
-              this->setEvidence(
-                  var, combination[this->evidence_vars_positions[var_pos]]);
-              ++var_pos;
-            }
+        [&](const categoric::CombinationMatrix::Row &combination,
+            std::size_t weight) {
+          for (std::size_t k = 0; k < values.size(); ++k) {
+            values[k] = combination[evidences_positions[k].second];
+          }
+          auto [it, added] = buckets_positions.emplace(values, buckets.size());
+          if (added) {
+            buckets.push_back(EvidencesBucket{values, weight});
+          } else {
+            buckets[it->second].samples += weight;
           }
-          propagateBelief(strct::PropagationKind::SUM);
-          this->getPool().parallelFor(tasks);
         });
   }
+  const auto chunks =
+      categoric::partition_domain(buckets.size(), getPool().size());
+  if (chunks.size() == 1) {
+    accumulateBetas(evidences_positions, buckets, 0, buckets.size(), coeff,
+                    betas);
+  } else {
+    // every chunk of buckets is processed by a different replica, as this
+    // model is using the pool to run the chunks
+    while (replicas.size() < chunks.size()) {
+      replicas.emplace_back(std::make_unique<ConditionalRandomField>(*this));
+    }
+    const auto weights = getWeights();
+    for (auto &replica : replicas) {
+      replica->setWeights(weights);
+      replica->sharePropagationSettings(*this);
+    }
+    std::vector<std::vector<float>> chunks_betas(
+        chunks.size(), std::vector<float>(tuners.size(), 0));
+    std::vector<std::exception_ptr> errors(chunks.size());
+    strct::Tasks tasks;
+    for (std::size_t c = 0; c < chunks.size(); ++c) {
+      tasks.emplace_back([&, c](const std::size_t) {
+        try {
+          replicas[c]->accumulateBetas(evidences_positions, buckets,
+                                       chunks[c].first, chunks[c].second,
+                                       coeff, chunks_betas[c]);
+        } catch (...) {
+          errors[c] = std::current_exception();
+        }
+      });
+    }
+    getPool().parallelFor(tasks);
+    for (const auto &error : errors) {
+      if (error != nullptr) {
+        std::rethrow_exception(error);
+      }
+    }
+    for (const auto &chunk_betas : chunks_betas) {
+      for (std::size_t t = 0; t < betas.size(); ++t) {
+        betas[t] += chunk_betas[t];
+      }
+    }
+  }
   for (std::size_t k = 0; k < alfas.size(); ++k) {
     alfas[k] -= betas[k];
   }
   return alfas;
 }
 
-std::vector<std::vector<std::size_t>> ConditionalRandomField::makeTrainSet(
+void ConditionalRandomField::accumulateBetas(
+    const EvidencesPositions &evidences_positions,
+    const std::vector<EvidencesBucket> &buckets, std::size_t begin,
+    std::size_t end, float coeff, std::vector<float> &betas) {
+  strct::Evidences evidences = state().evidences;
+  std::vector<std::size_t *> values;
+  for (const auto &[var, pos] : evidences_positions) {
+    values.push_back(&evidences.find(var)->second);
+  }
+  for (std::size_t b = begin; b < end; ++b) {
+    const auto &bucket = buckets[b];
+    for (std::size_t k = 0; k < values.size(); ++k) {
+      *values[k] = bucket.values[k];
+    }
+    EvidenceSetter::setEvidences(evidences);
+    propagateBelief(strct::PropagationKind::SUM);
+    const float weighted_coeff = coeff * static_cast<float>(bucket.samples);
+    for (std::size_t t = 0; t < tuners.size(); ++t) {
+      betas[t] += weighted_coeff * tuners[t]->getGradientBeta();
+    }
+  }
+}
+
+categoric::CombinationMatrix ConditionalRandomField::makeTrainSet(
     const GibbsSampler::SamplesGenerationContext &context,
     float range_percentage, const std::size_t threads) {
   if ((range_percentage > 1.f) || (range_percentage < 0)) {
@@ -194,10 +266,15 @@ std::vector<std::vector<std::size_t>> ConditionalRandomField::makeTrainSet(
   std::vector<std::size_t> hidden_vars_position =
       find_positions(getAllVariables(), getHiddenVariables());
 
-  std::vector<std::vector<std::size_t>> result;
+  const auto &all_vars = getAllVariables();
+  std::size_t max_value = 0;
+  for (const auto &var : all_vars) {
+    max_value = std::max(max_value, var->size() - 1);
+  }
+  categoric::CombinationMatrix result{all_vars.size(), max_value};
   auto emplace_samples = [&](const auto &ev) {
     this->setEvidences(ev);
-    for (const auto &sample : this->makeSamples(context, threads)) {
+    for (const auto sample : this->makeSamples(context, threads)) {
       result.push_back(sample);
     }
   };
@@ -205,7 +282,11 @@ std::vector<std::vector<std::size_t>> ConditionalRandomField::makeTrainSet(
   const auto evidence_set = getObservedVariables();
   auto evidences_group = categoric::Group{
       categoric::VariablesSoup{evidence_set.begin(), evidence_set.end()}};
-  categoric::GroupRange evidences_range(evidences_group);
+  std::vector<std::size_t> evidences_sizes;
+  for (const auto &var : evidences_group.getVariables()) {
+    evidences_sizes.push_back(var->size());
+  }
+  categoric::Odometer evidences_range(evidences_sizes);
   if (1.f == range_percentage) {
     categoric::for_each_combination(evidences_range, emplace_samples);
   } else {
@@ -213,16 +294,9 @@ std::vector<std::vector<std::size_t>> ConditionalRandomField::makeTrainSet(
     const std::size_t result_size_approx =
         static_cast<std::size_t>(floorf(result_max_size * range_percentage));
     const std::size_t delta = result_max_size / result_size_approx;
-    std::size_t k = 0;
-    while (k < result_max_size) {
-      emplace_samples(*evidences_range);
-      if ((k + delta) >= result_max_size) {
-        break;
-      }
-      for (std::size_t i = 0; i < delta; ++i) {
-        ++evidences_range;
-      }
-      k += delta;
+    for (std::size_t k = 0; k < result_max_size; k += delta) {
+      evidences_range.seek(k);
+      emplace_samples(evidences_range.combination());
     }
   }
   return result;
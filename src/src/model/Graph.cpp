@@ -11,8 +11,6 @@ namespace EFG::model {
 void Graph::absorb(const strct::FactorsAware &to_absorb, bool copy) {
   const auto &factors = to_absorb.getAllFactors();
   absorbConstFactors(factors.begin(), factors.end(), copy);
-  for (const auto &[var, val] : to_absorb.getEvidences()) {
-    setEvidence(var, val);
-  }
+  setEvidences(to_absorb.getEvidences());
 }
 } // namespace EFG::model
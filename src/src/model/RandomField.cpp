@@ -5,10 +5,26 @@
  * report any bug to andrecasa91@gmail.com.
  **/
 
+#include <EasyFactorGraph/Error.h>
 #include <EasyFactorGraph/misc/Cast.h>
 #include <EasyFactorGraph/model/RandomField.h>
 
 namespace EFG::model {
+namespace {
+// runs the predicate for every tuner, in parallel
+template <typename Pred>
+void for_each_tuner(strct::Pool &pool, train::Tuners &tuners,
+                    const Pred &pred) {
+  strct::Tasks tasks;
+  for (std::size_t pos = 0; pos < tuners.size(); ++pos) {
+    tasks.emplace_back([&pred, pos, &tuner = *tuners[pos]](const std::size_t) {
+      pred(pos, tuner);
+    });
+  }
+  pool.parallelFor(tasks);
+}
+} // namespace
+
 void RandomField::absorb(const strct::FactorsAware &to_absorb, bool copy) {
   castConstAndUse<strct::FactorsConstGetter>(
       to_absorb,
@@ -22,32 +38,61 @@ void RandomField::absorb(const strct::FactorsAware &to_absorb, bool copy) {
        &copy](const train::FactorsTunableGetter &as_factor_tunable_aware) {
         this->absorbTunableClusters(as_factor_tunable_aware, copy);
       });
-  for (const auto &[var, val] : to_absorb.getEvidences()) {
-    setEvidence(var, val);
-  }
+  setEvidences(to_absorb.getEvidences());
 }
 
 std::vector<float> RandomField::getWeightsGradient_(
     const train::TrainSet::Iterator &train_set_combinations) {
+  prepareBetas();
+  std::vector<float> result;
+  result.resize(tuners.size());
+  for_each_tuner(getPool(), tuners, [&](std::size_t pos, train::Tuner &tuner) {
+    result[pos] = tuner.getGradientAlpha(train_set_combinations) -
+                  tuner.getGradientBeta();
+  });
+  return result;
+}
+
+std::vector<float> RandomField::getWeightsGradientFromSource_(
+    train::TrainSetSource &train_set_source) {
+  // betas don't depend on the train set: the belief is propagated only once,
+  // while the alphas of all the chunks are accumulated
+  prepareBetas();
+  std::vector<float> result(tuners.size(), 0);
+  std::size_t samples = 0;
+  {
+    train::ScopedRewind rewind{train_set_source};
+    while (auto chunk = train_set_source.nextChunk()) {
+      if (chunk->empty()) {
+        continue;
+      }
+      const train::TrainSet chunk_set{std::move(chunk.value())};
+      const auto chunk_it = chunk_set.makeIterator();
+      const float chunk_samples = static_cast<float>(chunk_set.size());
+      for_each_tuner(getPool(), tuners,
+                     [&](std::size_t pos, train::Tuner &tuner) {
+                       result[pos] +=
+                           chunk_samples * tuner.getGradientAlpha(chunk_it);
+                     });
+      samples += chunk_set.size();
+    }
+  }
+  if (samples == 0) {
+    throw Error{"empty train set"};
+  }
+  const float coeff = 1.f / static_cast<float>(samples);
+  for_each_tuner(getPool(), tuners, [&](std::size_t pos, train::Tuner &tuner) {
+    result[pos] = coeff * result[pos] - tuner.getGradientBeta();
+  });
+  return result;
+}
+
+void RandomField::prepareBetas() {
   if (!getEvidences().empty()) {
     removeAllEvidences();
   }
   resetBelief();
   propagateBelief(strct::PropagationKind::SUM);
-  std::vector<float> result;
-  result.resize(tuners.size());
-  strct::Tasks tasks;
-  std::size_t result_pos = 0;
-  for (auto &tuner : tuners) {
-    tasks.emplace_back([&receiver = result[result_pos], &tuner = tuner,
-                        &train_set_combinations](const std::size_t) {
-      receiver = tuner->getGradientAlpha(train_set_combinations) -
-                 tuner->getGradientBeta();
-    });
-    ++result_pos;
-  }
-  getPool().parallelFor(tasks);
-  return result;
 }
 
 } // namespace EFG::model
@@ -54,9 +54,8 @@ void EvidenceSetter::setEvidence(const categoric::VariablePtr &variable,
 
   for (auto &[connected_node, connection] : node->disabled_connections) {
     auto connection_it = connected_node->disabled_connections.find(node);
-    connection_it->second.message = std::make_unique<factor::Evidence>(
-        *connection_it->second.factor, node->variable,
-        evidence_location->second);
+    connection_it->second.setEvidenceMessage(node->variable,
+                                             evidence_location->second);
     connected_node->merged_unaries.reset();
   }
   resetBelief();
@@ -67,6 +66,79 @@ void EvidenceSetter::setEvidence(const std::string &variable,
   setEvidence(findVariable(variable), value);
 }
 
+void EvidenceSetter::setEvidences(const Evidences &evidences) {
+  auto &state = stateMutable();
+  std::vector<std::pair<Node *, std::size_t>> to_set;
+  to_set.reserve(evidences.size());
+  for (const auto &[variable, value] : evidences) {
+    auto node_it = state.nodes.find(variable);
+    if (node_it == state.nodes.end()) {
+      throw Error::make(variable->name(), " is a non existing variable");
+    }
+    if (variable->size() <= value) {
+      throw Error::make(std::to_string(value),
+                        " is an invalid evidence for variable ",
+                        variable->name());
+    }
+    to_set.emplace_back(node_it->second.get(), value);
+  }
+  if (to_set.empty()) {
+    return;
+  }
+
+  std::unordered_set<Node *> newly_observed;
+  for (auto &[node, value] : to_set) {
+    auto evidence_it = state.evidences.find(node->variable);
+    if (evidence_it != state.evidences.end()) {
+      evidence_it->second = value;
+      continue;
+    }
+    while (!node->active_connections.empty()) {
+      Node::disable(*node, *node->active_connections.begin()->first);
+    }
+    state.evidences.emplace(node->variable, value);
+    newly_observed.emplace(node);
+  }
+
+  // split only the clusters containing a newly observed node
+  if (!newly_observed.empty()) {
+    HiddenClusters splitted;
+    for (auto it = state.clusters.begin(); it != state.clusters.end();) {
+      std::unordered_set<Node *> remaining;
+      for (auto *node : it->nodes) {
+        if (newly_observed.find(node) == newly_observed.end()) {
+          remaining.emplace(node);
+        }
+      }
+      if (remaining.size() == it->nodes.size()) {
+        ++it;
+        continue;
+      }
+      it = state.clusters.erase(it);
+      splitted.splice(splitted.end(), compute_clusters(remaining));
+    }
+    state.clusters.splice(state.clusters.end(), splitted);
+  }
+
+  for (auto &[node, value] : to_set) {
+    for (auto &[connected_node, connection] : node->disabled_connections) {
+      auto connection_it = connected_node->disabled_connections.find(node);
+      connection_it->second.setEvidenceMessage(node->variable, value);
+      connected_node->merged_unaries.reset();
+    }
+  }
+  resetBelief();
+}
+
+void EvidenceSetter::setEvidences(
+    const std::unordered_map<std::string, std::size_t> &ev) {
+  Evidences evidences;
+  for (const auto &[name, value] : ev) {
+    evidences.emplace(findVariable(name), value);
+  }
+  setEvidences(evidences);
+}
+
 void EvidenceRemover::removeEvidence_(const categoric::VariablePtr &variable) {
   auto &state = stateMutable();
   auto evidence_it = state.evidences.find(variable);
@@ -13,6 +13,12 @@ void FactorsConstInserter::addConstFactor(const factor::ImmutablePtr &factor) {
   const_factors.emplace(factor);
 }
 
+void FactorsConstInserter::addConstFactors(
+    const std::vector<factor::ImmutablePtr> &factors) {
+  addDistributions(factors);
+  const_factors.insert(factors.begin(), factors.end());
+}
+
 void FactorsConstInserter::copyConstFactor(const factor::Immutable &factor) {
   auto cloned = std::make_shared<factor::Factor>(
       factor, factor::Factor::CloneTrasformedImagesTag{});
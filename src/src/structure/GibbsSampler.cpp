@@ -172,7 +172,7 @@ void evolve_samples(strct::Pool &pool, const std::vector<Tasks> &sample_jobs,
 }
 } // namespace
 
-std::vector<std::vector<std::size_t>>
+categoric::CombinationMatrix
 GibbsSampler::makeSamples(const SamplesGenerationContext &context,
                           const std::size_t threads) {
   ScopedPoolActivator activator(*this, threads);
@@ -188,7 +188,11 @@ GibbsSampler::makeSamples(const SamplesGenerationContext &context,
       make_sampling_tasks(sampling_nodes, engines, context.seed, pool);
 
   evolve_samples(pool, sampling_tasks, burn_out);
-  std::vector<std::vector<std::size_t>> result;
+  std::size_t max_value = 0;
+  for (const auto &var : getAllVariables()) {
+    max_value = std::max(max_value, var->size() - 1);
+  }
+  categoric::CombinationMatrix result{combination.size(), max_value};
   result.reserve(context.samples_number);
   while (result.size() != context.samples_number) {
     result.push_back(combination);
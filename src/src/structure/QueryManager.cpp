@@ -138,8 +138,10 @@ QueryManager::getJointMarginalDistribution(const categoric::Group &subgroup,
         .visit(location);
   }
 
+  ScopedPoolActivator activator(*this, threads);
   return factor::Factor{std::vector<const factor::Immutable *>{
-                            contributions.begin(), contributions.end()}}
+                            contributions.begin(), contributions.end()},
+                        getPool()}
       .cloneWithPermutedGroup(subgroup);
 }
 
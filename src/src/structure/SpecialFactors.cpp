@@ -6,6 +6,7 @@
  **/
 
 #include <EasyFactorGraph/Error.h>
+#include <EasyFactorGraph/factor/FixedArityFunction.h>
 #include <EasyFactorGraph/structure/SpecialFactors.h>
 
 #include <cmath>
@@ -40,7 +41,7 @@ public:
       imgs.push_back(1.f);
     }
     data_ = std::move(imgs);
-    imgs_ = std::get_if<std::vector<float>>(&data_);
+    imgs_ = std::get_if<DenseContainer>(&data_);
   }
 
   void merge(const Function &subject) {
@@ -49,6 +50,7 @@ public:
       *it *= img;
       ++it;
     });
+    imagesChanged();
   }
 
   void normalize() {
@@ -56,10 +58,11 @@ public:
     for (auto &val : *imgs_) {
       val *= coeff;
     }
+    imagesChanged();
   }
 
 private:
-  std::vector<float> *imgs_;
+  DenseContainer *imgs_;
 };
 } // namespace
 
@@ -121,13 +124,51 @@ Evidence::Evidence(const Immutable &binary_factor,
   std::size_t pos_evidence;
   std::size_t pos_hidden;
   get_positions(binary_factor, getVariable(), pos_hidden, pos_evidence);
-  auto &data = functionMutable();
-  binary_factor.function().forEachCombination<true>(
-      [&](const auto &comb, float img) {
-        if (comb[pos_evidence] == evidence) {
-          data.set(std::vector<std::size_t>{comb[pos_hidden]}, img);
-        }
-      });
+  // only the slice of the binary images related to the evidence is read
+  const auto binary_images = binary_factor.function().getTransformedImages();
+  const auto &binary_strides = binary_factor.function().getInfo().strides;
+  const std::size_t hidden_stride = binary_strides[pos_hidden];
+  const float *slice =
+      binary_images->data() + evidence * binary_strides[pos_evidence];
+  std::vector<float> images;
+  images.reserve(getVariable()->size());
+  for (std::size_t h = 0; h < getVariable()->size(); ++h) {
+    images.push_back(slice[h * hidden_stride]);
+  }
+  functionMutable().setDenseImages(std::move(images));
+}
+
+Evidence::Evidence(const categoric::VariablePtr &hidden_var,
+                   std::vector<float> images)
+    : UnaryFactor(std::make_shared<Function>(hidden_var)) {
+  functionMutable().setDenseImages(std::move(images));
+}
+
+std::vector<std::shared_ptr<const Evidence>>
+Evidence::makeSlices(const Immutable &binary_factor,
+                     const categoric::VariablePtr &evidence_var) {
+  auto hidden_var = get_other_var(binary_factor, evidence_var);
+  std::size_t pos_evidence;
+  std::size_t pos_hidden;
+  get_positions(binary_factor, hidden_var, pos_hidden, pos_evidence);
+  const auto binary_images = binary_factor.function().getTransformedImages();
+  const auto &binary_info = binary_factor.function().getInfo();
+  const std::size_t hidden_size = binary_info.sizes[pos_hidden];
+  const std::size_t hidden_stride = binary_info.strides[pos_hidden];
+  const std::size_t evidence_size = binary_info.sizes[pos_evidence];
+  const std::size_t evidence_stride = binary_info.strides[pos_evidence];
+  std::vector<std::shared_ptr<const Evidence>> result;
+  result.reserve(evidence_size);
+  for (std::size_t e = 0; e < evidence_size; ++e) {
+    const float *row = binary_images->data() + e * evidence_stride;
+    std::vector<float> images;
+    images.reserve(hidden_size);
+    for (std::size_t h = 0; h < hidden_size; ++h) {
+      images.push_back(row[h * hidden_stride]);
+    }
+    result.emplace_back(new Evidence{hidden_var, std::move(images)});
+  }
+  return result;
 }
 
 Indicator::Indicator(const categoric::VariablePtr &var, std::size_t value)
@@ -146,21 +187,25 @@ void fill_message(const UnaryFactor &merged_unaries,
   std::size_t sender_pos;
   get_positions(binary_factor, merged_unaries.getVariable(), message_pos,
                 sender_pos);
-  std::size_t message_size =
-      binary_factor.function().vars().getVariables()[message_pos]->size();
+  const UnaryFunction sender{merged_unaries.function(), true};
+  // cached by the binary factor, as they are needed by every message
+  const auto binary_images = binary_factor.function().getTransformedImages();
+  const auto &binary_info = binary_factor.function().getInfo();
+  const std::size_t message_size = binary_info.sizes[message_pos];
+  const std::size_t sender_size = binary_info.sizes[sender_pos];
+  UnaryFunction result{UnaryFunction::Combination{message_size}};
+  const auto &sender_images = sender.images();
+  const std::size_t message_stride = binary_info.strides[message_pos];
+  const std::size_t sender_stride = binary_info.strides[sender_pos];
   for (std::size_t r = 0; r < message_size; ++r) {
     ReducerT reducer{};
-    merged_unaries.function().forEachCombination<true>(
-        [&](const auto &sender_comb, float sender_val) {
-          std::vector<std::size_t> binary_factor_comb;
-          binary_factor_comb.resize(2);
-          binary_factor_comb[sender_pos] = sender_comb.front();
-          binary_factor_comb[message_pos] = r;
-          reducer.update(sender_val * binary_factor.function().findTransformed(
-                                          binary_factor_comb));
-        });
-    recipient.set(std::vector<std::size_t>{r}, reducer.val);
+    const float *binary_img = binary_images->data() + r * message_stride;
+    for (std::size_t s = 0; s < sender_size; ++s, binary_img += sender_stride) {
+      reducer.update(sender_images[s] * *binary_img);
+    }
+    result.images()[r] = reducer.val;
   }
+  result.copyTo(recipient);
 }
 } // namespace
 
@@ -34,10 +34,19 @@ void Node::updateMergedUnaries() {
   merged_unaries.reset(std::make_unique<factor::MergedUnaries>(unary_factors));
 }
 
+void Node::Connection::setEvidenceMessage(
+    const categoric::VariablePtr &sender, std::size_t evidence) {
+  if (evidence_slices.empty()) {
+    evidence_slices = factor::Evidence::makeSlices(*factor, sender);
+  }
+  message = evidence_slices[evidence];
+}
+
 namespace {
 Node::Connection *reset(Node::Connection &subject,
                         const factor::ImmutablePtr &factor) {
   subject.message.reset();
+  subject.evidence_slices.clear();
   subject.factor = factor;
   return &subject;
 }
@@ -88,7 +97,7 @@ HiddenCluster::TopologyInfo::updateMessage(PropagationKind kind) {
     unary_factors.push_back(dep->message.get());
   }
   factor::MergedUnaries merged_unaries(unary_factors);
-  std::unique_ptr<const factor::UnaryFactor> previous_message =
+  std::shared_ptr<const factor::UnaryFactor> previous_message =
       std::move(connection->message);
   switch (kind) {
   case PropagationKind::SUM:
@@ -134,47 +143,68 @@ void HiddenCluster::updateConnectivity() {
 }
 
 namespace {
-std::list<std::unordered_set<Node *>>
-compute_clusters_(const std::unordered_set<Node *> &nodes) {
-  using Cluster = std::unordered_set<Node *>;
-  std::list<Cluster> res;
-  for (auto *node : nodes) {
-    using Iter = std::list<Cluster>::iterator;
-    std::unordered_map<const Cluster *, Iter> neighbour;
-    for (const auto &[node, _] : node->active_connections) {
-      auto it = std::find_if(res.begin(), res.end(),
-                             [&node = node](const Cluster &cl) {
-                               return cl.find(node) != cl.end();
-                             });
-      if (it != res.end()) {
-        neighbour[&(*it)] = it;
-      }
+class DisjointSets {
+public:
+  DisjointSets(std::size_t size) : parents(size), ranks(size, 0) {
+    for (std::size_t k = 0; k < size; ++k) {
+      parents[k] = k;
     }
-    switch (neighbour.size()) {
-    case 0:
-      res.emplace_back().emplace(node);
-      break;
-    case 1:
-      neighbour.begin()->second->emplace(node);
-      break;
-    default: {
-      auto &added = res.emplace_back();
-      added.emplace(node);
-      for (const auto &[_, it] : neighbour) {
-        added.insert(it->begin(), it->end());
-        res.erase(it);
-      }
-    } break;
+  }
+
+  std::size_t find(std::size_t element) {
+    while (parents[element] != element) {
+      // path halving
+      parents[element] = parents[parents[element]];
+      element = parents[element];
     }
+    return element;
   }
-  return res;
-}
+
+  void unite(std::size_t a, std::size_t b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) {
+      return;
+    }
+    if (ranks[a] < ranks[b]) {
+      std::swap(a, b);
+    }
+    parents[b] = a;
+    if (ranks[a] == ranks[b]) {
+      ++ranks[a];
+    }
+  }
+
+private:
+  std::vector<std::size_t> parents;
+  std::vector<std::size_t> ranks;
+};
 } // namespace
 
 HiddenClusters compute_clusters(const std::unordered_set<Node *> &nodes) {
+  std::vector<Node *> nodes_list{nodes.begin(), nodes.end()};
+  std::unordered_map<const Node *, std::size_t> indices;
+  indices.reserve(nodes_list.size());
+  for (std::size_t k = 0; k < nodes_list.size(); ++k) {
+    indices.emplace(nodes_list[k], k);
+  }
+  DisjointSets sets{nodes_list.size()};
+  for (std::size_t k = 0; k < nodes_list.size(); ++k) {
+    for (const auto &[neighbour, _] : nodes_list[k]->active_connections) {
+      // neighbours not in the passed set are ignored
+      if (auto it = indices.find(neighbour); it != indices.end()) {
+        sets.unite(k, it->second);
+      }
+    }
+  }
   HiddenClusters res;
-  for (auto &&set : compute_clusters_(nodes)) {
-    res.emplace_back().nodes = std::move(set);
+  std::unordered_map<std::size_t, HiddenCluster *> clusters;
+  for (std::size_t k = 0; k < nodes_list.size(); ++k) {
+    auto [it, added] = clusters.emplace(sets.find(k), nullptr);
+    if (added) {
+      it->second = &res.emplace_back();
+    }
+    it->second->nodes.emplace(nodes_list[k]);
   }
   return res;
 }
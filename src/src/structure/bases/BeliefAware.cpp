@@ -22,6 +22,11 @@ void BeliefAware::setLoopyPropagationStrategy(
   loopy_propagator = std::move(strategy);
 }
 
+void BeliefAware::sharePropagationSettings(const BeliefAware &o) {
+  context = o.context;
+  loopy_propagator = o.loopy_propagator;
+}
+
 bool BeliefAware::wouldNeedPropagation(PropagationKind kind) const {
   return (!lastPropagation.has_value()) ||
          (lastPropagation->propagation_kind_done != kind);
@@ -74,6 +79,7 @@ bool message_passing(HiddenCluster &cluster, const PropagationKind &kind,
 } // namespace
 
 void BeliefAware::propagateBelief(PropagationKind kind) {
+  refreshBelief();
   if (!wouldNeedPropagation(kind)) {
     return;
   }
@@ -10,6 +10,7 @@
 #include <EasyFactorGraph/structure/bases/FactorsAware.h>
 
 #include <algorithm>
+#include <set>
 
 namespace EFG::strct {
 void FactorsAware::addDistribution(
@@ -56,6 +57,7 @@ FactorsAware::findOrMakeNode(const categoric::VariablePtr &var) {
   // create this node
   auto &state = stateMutable();
   state.variables.push_back(var);
+  state.variables_by_name.emplace(var->name(), var);
   auto *added =
       state.nodes.emplace(var, std::make_unique<Node>()).first->second.get();
   added->variable = var;
@@ -78,9 +80,8 @@ namespace {
 void hybrid_insertion(Node *node_hidden, Node *node_evidence,
                       std::size_t evidence,
                       const EFG::factor::ImmutablePtr &binary_factor) {
-  Node::disable(*node_hidden, *node_evidence, binary_factor).first->message =
-      std::make_unique<factor::Evidence>(*binary_factor,
-                                         node_evidence->variable, evidence);
+  Node::disable(*node_hidden, *node_evidence, binary_factor)
+      .first->setEvidenceMessage(node_evidence->variable, evidence);
   node_hidden->merged_unaries.reset();
 };
 } // namespace
@@ -134,4 +135,125 @@ void FactorsAware::addBinaryDistribution(
       }}
       .visit(nodeA_location.location);
 }
+
+void FactorsAware::checkDistributions(
+    const std::vector<EFG::factor::ImmutablePtr> &distributions) const {
+  const auto &state = this->state();
+  std::unordered_set<const factor::Immutable *> batch;
+  std::unordered_map<std::string, const categoric::Variable *> new_variables;
+  auto check_variable = [&](const categoric::VariablePtr &var) {
+    if (auto it = state.nodes.find(var); it != state.nodes.end()) {
+      check_is_same_variable(var, it->second->variable);
+      return;
+    }
+    auto [it, added] = new_variables.emplace(var->name(), var.get());
+    if (!added && (it->second != var.get())) {
+      throw Error::make("Trying to insert variable named: ", var->name(),
+                        " multiple times with different VariablePtr");
+    }
+  };
+  std::set<std::pair<const categoric::Variable *, const categoric::Variable *>>
+      connections;
+  for (const auto &distribution : distributions) {
+    if (nullptr == distribution) {
+      throw Error{"null distribution can't be add"};
+    }
+    if ((factorsAll.find(distribution) != factorsAll.end()) ||
+        !batch.emplace(distribution.get()).second) {
+      throw Error{"Already inserted factor"};
+    }
+    const auto &vars = distribution->function().vars().getVariables();
+    for (const auto &var : vars) {
+      check_variable(var);
+    }
+    switch (vars.size()) {
+    case 1:
+      break;
+    case 2: {
+      auto already_connected = [&]() {
+        throw Error::make(vars.front()->name(), " and ", vars.back()->name(),
+                          " are already connected");
+      };
+      auto nodeA = state.nodes.find(vars.front());
+      auto nodeB = state.nodes.find(vars.back());
+      if ((nodeA != state.nodes.end()) && (nodeB != state.nodes.end())) {
+        const auto *a = nodeA->second.get();
+        auto *b = nodeB->second.get();
+        if ((a->active_connections.find(b) != a->active_connections.end()) ||
+            (a->disabled_connections.find(b) !=
+             a->disabled_connections.end())) {
+          already_connected();
+        }
+      }
+      auto key = std::make_pair(vars.front().get(), vars.back().get());
+      if (key.second < key.first) {
+        std::swap(key.first, key.second);
+      }
+      if (!connections.emplace(key).second) {
+        already_connected();
+      }
+    } break;
+    default:
+      throw Error{"Factor with invalid number of variables"};
+    }
+  }
+}
+
+void FactorsAware::addDistributions(
+    const std::vector<EFG::factor::ImmutablePtr> &distributions) {
+  checkDistributions(distributions);
+  resetBelief();
+
+  auto &state = stateMutable();
+  auto get_node = [&state](const categoric::VariablePtr &var) {
+    auto it = state.nodes.find(var);
+    if (it == state.nodes.end()) {
+      state.variables.push_back(var);
+      state.variables_by_name.emplace(var->name(), var);
+      it = state.nodes.emplace(var, std::make_unique<Node>()).first;
+      it->second->variable = var;
+    }
+    return it->second.get();
+  };
+  auto find_evidence = [&state](const categoric::VariablePtr &var)
+      -> std::optional<std::size_t> {
+    if (auto it = state.evidences.find(var); it != state.evidences.end()) {
+      return it->second;
+    }
+    return std::nullopt;
+  };
+  for (const auto &distribution : distributions) {
+    const auto &vars = distribution->function().vars().getVariables();
+    if (vars.size() == 1) {
+      auto *node = get_node(vars.front());
+      node->unary_factors.push_back(distribution);
+      node->merged_unaries.reset();
+    } else {
+      auto *nodeA = get_node(vars.front());
+      auto *nodeB = get_node(vars.back());
+      const auto evidenceA = find_evidence(vars.front());
+      const auto evidenceB = find_evidence(vars.back());
+      if (evidenceA.has_value() && evidenceB.has_value()) {
+        Node::disable(*nodeA, *nodeB, distribution);
+      } else if (evidenceA.has_value()) {
+        hybrid_insertion(nodeB, nodeA, evidenceA.value(), distribution);
+      } else if (evidenceB.has_value()) {
+        hybrid_insertion(nodeA, nodeB, evidenceB.value(), distribution);
+      } else {
+        Node::activate(*nodeA, *nodeB, distribution);
+      }
+    }
+    factorsAll.emplace(distribution);
+  }
+
+  // clusters are recomputed from scratch, accounting for the new nodes and
+  // connections
+  std::unordered_set<Node *> hidden_nodes;
+  for (auto &[var, node] : state.nodes) {
+    if (state.evidences.find(var) == state.evidences.end()) {
+      hidden_nodes.emplace(node.get());
+    }
+  }
+  state.clusters = compute_clusters(hidden_nodes);
+}
 } // namespace EFG::strct
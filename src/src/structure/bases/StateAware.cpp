@@ -12,15 +12,11 @@
 
 namespace EFG::strct {
 categoric::VariablePtr StateAware::findVariable(const std::string &name) const {
-  auto variables_it =
-      std::find_if(state_.variables.begin(), state_.variables.end(),
-                   [&name](const categoric::VariablePtr &var) {
-                     return var->name() == name;
-                   });
-  if (variables_it == state_.variables.end()) {
+  auto variables_it = state_.variables_by_name.find(name);
+  if (variables_it == state_.variables_by_name.end()) {
     throw Error::make(name, " is an inexistent variable");
   }
-  return *variables_it;
+  return variables_it->second;
 }
 
 categoric::VariablesSet StateAware::getHiddenVariables() const {
@@ -44,21 +44,113 @@ FactorsTunableGetter::getTunableClusters() const {
 
 std::vector<float> FactorsTunableGetter::getWeights() const {
   std::vector<float> result;
-  result.reserve(tuners.size());
-  for (const auto &tuner : tuners) {
-    result.push_back(tuner->getWeight());
+  result.reserve(weights_slots.size());
+  for (const auto &[buffer, position] : weights_slots) {
+    result.push_back((*buffer)[position]);
   }
   return result;
 }
 
 void FactorsTunableGetter::setWeights(const std::vector<float> &weights) {
-  if (weights.size() != tuners.size()) {
+  if (weights.size() != weights_slots.size()) {
     throw Error{"Invalid weights"};
   }
-  for (std::size_t k = 0; k < tuners.size(); ++k) {
-    tuners[k]->setWeight(weights[k]);
+  for (std::size_t k = 0; k < weights.size(); ++k) {
+    const auto &[buffer, position] = weights_slots[k];
+    buffer->set(position, weights[k]);
+  }
+  weightsUpdated();
+}
+
+std::optional<Span<const float>> FactorsTunableGetter::getWeightsSpan() const {
+  if (weights_slots.empty()) {
+    return Span<const float>{weights_buffer->data(), 0};
+  }
+  const auto &[buffer, first_position] = weights_slots.front();
+  for (std::size_t k = 1; k < weights_slots.size(); ++k) {
+    if ((weights_slots[k].buffer != buffer) ||
+        (weights_slots[k].position != first_position + k)) {
+      return std::nullopt;
+    }
+  }
+  return Span<const float>{buffer->data() + first_position,
+                           weights_slots.size()};
+}
+
+void FactorsTunableGetter::weightsUpdated() {
+  bool changed = false;
+  for (std::size_t k = 0; k < weights_slots.size(); ++k) {
+    const auto &[buffer, position] = weights_slots[k];
+    const float weight = (*buffer)[position];
+    if (weight == weights_snapshot[k]) {
+      continue;
+    }
+    weights_snapshot[k] = weight;
+    changed = true;
+    visitTuner(
+        tuners[k].get(),
+        [this](const BaseTuner &base) { invalidateCaches(base.getFactor()); },
+        [this](const CompositeTuner &composite) {
+          for (const auto &element : composite.getElements()) {
+            invalidateCaches(*extract_factor(*element));
+          }
+        });
+  }
+  for (auto &[buffer, version] : buffers_versions) {
+    version = buffer->version();
+  }
+  if (changed) {
+    resetBelief();
+  }
+}
+
+void FactorsTunableGetter::refreshBelief() {
+  for (const auto &[buffer, version] : buffers_versions) {
+    if (buffer->version() != version) {
+      weightsUpdated();
+      return;
+    }
+  }
+}
+
+void FactorsTunableGetter::trackBuffer(
+    const factor::WeightsBufferPtr &buffer) {
+  if (std::find_if(buffers_versions.begin(), buffers_versions.end(),
+                   [&buffer](const auto &tracked) {
+                     return tracked.first == buffer;
+                   }) == buffers_versions.end()) {
+    buffers_versions.emplace_back(buffer, buffer->version());
+  }
+}
+
+void FactorsTunableGetter::invalidateCaches(
+    const factor::FactorExponential &factor) {
+  auto &state = stateMutable();
+  const auto &vars = factor.function().vars().getVariables();
+  if (vars.size() == 1) {
+    state.nodes.find(vars.front())->second->merged_unaries.reset();
+    return;
   }
-  resetBelief();
+  // the messages sent by the evidences are slices of the factor, merged with
+  // the unaries of the receivers
+  auto refresh = [&state](strct::Node &receiver, strct::Node &sender) {
+    auto it = receiver.disabled_connections.find(&sender);
+    if (it == receiver.disabled_connections.end()) {
+      return;
+    }
+    auto &connection = it->second;
+    connection.evidence_slices.clear();
+    auto evidence_it = state.evidences.find(sender.variable);
+    if ((connection.message != nullptr) &&
+        (evidence_it != state.evidences.end())) {
+      connection.setEvidenceMessage(sender.variable, evidence_it->second);
+    }
+    receiver.merged_unaries.reset();
+  };
+  auto &nodeA = *state.nodes.find(vars.front())->second;
+  auto &nodeB = *state.nodes.find(vars.back())->second;
+  refresh(nodeA, nodeB);
+  refresh(nodeB, nodeA);
 }
 
 std::vector<float> FactorsTunableGetter::getWeightsGradient(
@@ -68,6 +160,79 @@ std::vector<float> FactorsTunableGetter::getWeightsGradient(
   return getWeightsGradient_(train_set_combinations);
 }
 
+std::vector<float>
+FactorsTunableGetter::getWeightsGradient(TrainSetSource &train_set_source,
+                                         const std::size_t threads) {
+  ScopedPoolActivator activator(*this, threads);
+  return getWeightsGradientFromSource_(train_set_source);
+}
+
+namespace {
+// average of the gradients of all the chunks, weighted by the number of
+// samples in every chunk
+template <typename GradientPred>
+std::vector<float> average_over_chunks(TrainSetSource &train_set_source,
+                                       std::size_t size,
+                                       const GradientPred &gradient_of) {
+  std::vector<float> result(size, 0);
+  std::size_t samples = 0;
+  {
+    ScopedRewind rewind{train_set_source};
+    while (auto chunk = train_set_source.nextChunk()) {
+      if (chunk->empty()) {
+        continue;
+      }
+      const TrainSet chunk_set{std::move(chunk.value())};
+      const auto chunk_gradient = gradient_of(chunk_set.makeIterator());
+      const float chunk_samples = static_cast<float>(chunk_set.size());
+      for (std::size_t k = 0; k < result.size(); ++k) {
+        result[k] += chunk_samples * chunk_gradient[k];
+      }
+      samples += chunk_set.size();
+    }
+  }
+  if (samples == 0) {
+    throw Error{"empty train set"};
+  }
+  const float coeff = 1.f / static_cast<float>(samples);
+  for (auto &value : result) {
+    value *= coeff;
+  }
+  return result;
+}
+} // namespace
+
+std::vector<float> FactorsTunableGetter::getWeightsGradientFromSource_(
+    TrainSetSource &train_set_source) {
+  return average_over_chunks(
+      train_set_source, tuners.size(),
+      [this](const TrainSet::Iterator &chunk_combinations) {
+        return getWeightsGradient_(chunk_combinations);
+      });
+}
+
+std::vector<float> FactorsTunableGetter::getPseudoLikelihoodGradient(
+    const TrainSet::Iterator &train_set_combinations,
+    const std::size_t threads) {
+  ScopedPoolActivator activator(*this, threads);
+  return getPseudoLikelihoodGradient_(train_set_combinations);
+}
+
+std::vector<float> FactorsTunableGetter::getPseudoLikelihoodGradient(
+    TrainSetSource &train_set_source, const std::size_t threads) {
+  ScopedPoolActivator activator(*this, threads);
+  return getPseudoLikelihoodGradientFromSource_(train_set_source);
+}
+
+std::vector<float> FactorsTunableGetter::getPseudoLikelihoodGradientFromSource_(
+    TrainSetSource &train_set_source) {
+  return average_over_chunks(
+      train_set_source, tuners.size(),
+      [this](const TrainSet::Iterator &chunk_combinations) {
+        return getPseudoLikelihoodGradient_(chunk_combinations);
+      });
+}
+
 Tuners::iterator FactorsTunableInserter::findTuner(
     const categoric::VariablesSet &tuned_vars_group) {
   auto tuners_it = std::find_if(
@@ -99,30 +264,100 @@ Tuners::iterator FactorsTunableInserter::findTuner(
   return tuners_it;
 }
 
-TunerPtr FactorsTunableInserter::makeTuner(const FactorExponentialPtr &factor) {
-  auto vars = getAllVariables();
+TunerPtr
+FactorsTunableInserter::makeTuner(const FactorExponentialPtr &factor,
+                                  const categoric::VariablesSoup &vars) {
+  const auto &nodes = state().nodes;
   const auto &factor_vars = factor->function().vars().getVariables();
   switch (factor_vars.size()) {
   case 1: {
-    auto *node = locate(factor_vars.front())->node;
+    auto *node = nodes.find(factor_vars.front())->second.get();
     return std::make_unique<UnaryTuner>(*node, factor, vars);
   }
   case 2: {
-    auto *nodeA = locate(factor_vars.front())->node;
-    auto *nodeB = locate(factor_vars.back())->node;
+    auto *nodeA = nodes.find(factor_vars.front())->second.get();
+    auto *nodeB = nodes.find(factor_vars.back())->second.get();
     return std::make_unique<BinaryTuner>(*nodeA, *nodeB, factor, vars);
   }
   }
   throw Error{"Invalid tunable factor"};
 }
 
+namespace {
+bool same_slot(const std::optional<factor::WeightSlot> &a,
+               const std::optional<factor::WeightSlot> &b) {
+  return a.has_value() && b.has_value() && (a->buffer == b->buffer) &&
+         (a->position == b->position);
+}
+} // namespace
+
+void FactorsTunableInserter::checkSharingGroups(
+    const std::vector<TunableFactorToAdd> &factors) {
+  struct Previous {
+    categoric::VariablesSet group;
+    // nullopt when a new slot will be created for the factor
+    std::optional<factor::WeightSlot> slot;
+  };
+  std::vector<Previous> previous;
+  previous.reserve(factors.size());
+  for (const auto &[factor, group_sharing_weight] : factors) {
+    auto slot = factor->getWeightSlot();
+    if (group_sharing_weight.has_value()) {
+      std::optional<factor::WeightSlot> cluster_slot;
+      auto previous_it =
+          std::find_if(previous.begin(), previous.end(),
+                       [&group = group_sharing_weight.value()](
+                           const Previous &p) { return p.group == group; });
+      if (previous_it == previous.end()) {
+        auto tuner_it = findTuner(group_sharing_weight.value());
+        cluster_slot = weights_slots[std::distance(tuners.begin(), tuner_it)];
+      } else {
+        cluster_slot = previous_it->slot;
+      }
+      if (slot.has_value() && !same_slot(slot, cluster_slot)) {
+        throw Error{"The factor is already bound to another weight, which "
+                    "can't be shared"};
+      }
+      slot = cluster_slot;
+    }
+    previous.push_back(
+        Previous{factor->function().vars().getVariablesSet(), slot});
+  }
+}
+
 void FactorsTunableInserter::addTunableFactor(
     const FactorExponentialPtr &factor,
     const std::optional<categoric::VariablesSet> &group_sharing_weight) {
+  checkSharingGroups({TunableFactorToAdd{factor, group_sharing_weight}});
   addDistribution(factor);
-  auto tuner = makeTuner(factor);
+  addTuner(factor, group_sharing_weight, getAllVariables());
+}
+
+void FactorsTunableInserter::addTunableFactors(
+    const std::vector<TunableFactorToAdd> &factors) {
+  checkSharingGroups(factors);
+  std::vector<factor::ImmutablePtr> distributions;
+  distributions.reserve(factors.size());
+  for (const auto &[factor, _] : factors) {
+    distributions.push_back(factor);
+  }
+  addDistributions(distributions);
+  const auto &vars = getAllVariables();
+  for (const auto &[factor, group_sharing_weight] : factors) {
+    addTuner(factor, group_sharing_weight, vars);
+  }
+}
+
+void FactorsTunableInserter::addTuner(
+    const FactorExponentialPtr &factor,
+    const std::optional<categoric::VariablesSet> &group_sharing_weight,
+    const categoric::VariablesSoup &vars) {
+  auto tuner = makeTuner(factor, vars);
   tunable_factors.emplace(factor);
   if (std::nullopt == group_sharing_weight) {
+    weights_slots.emplace_back(bindWeight(*factor));
+    weights_snapshot.push_back(factor->getWeight());
+    trackBuffer(weights_slots.back().buffer);
     tuners.emplace_back(std::move(tuner));
     return;
   }
@@ -134,12 +369,36 @@ void FactorsTunableInserter::addTunableFactor(
             std::make_unique<CompositeTuner>(std::move(*other_it),
                                              std::move(tuner));
         *other_it = std::move(new_composite);
-        other_it->get()->setWeight(other_it->get()->getWeight());
       },
       [&tuner](CompositeTuner &tuner_sharing) {
         tuner_sharing.addElement(std::move(tuner));
-        tuner_sharing.setWeight(tuner_sharing.getWeight());
       });
+  if (factor->getWeightSlot().has_value()) {
+    // already bound to the slot of the cluster (see checkSharingGroups)
+    return;
+  }
+  // the factor assumes the weight of the cluster
+  const auto &[buffer, position] =
+      weights_slots[std::distance(tuners.begin(), other_it)];
+  const float previous_weight = factor->getWeight();
+  factor->bindWeight(buffer, position);
+  if (previous_weight != factor->getWeight()) {
+    invalidateCaches(*factor);
+  }
+}
+
+factor::WeightSlot
+FactorsTunableInserter::bindWeight(factor::FactorExponential &factor) {
+  if (auto slot = factor.getWeightSlot(); slot.has_value()) {
+    // already tuned by another model: the buffer is shared with it
+    if (tuners.empty()) {
+      weights_buffer = slot->buffer;
+    }
+    return slot.value();
+  }
+  const std::size_t position = weights_buffer->push_back(factor.getWeight());
+  factor.bindWeight(weights_buffer, position);
+  return factor::WeightSlot{weights_buffer, position};
 }
 
 void FactorsTunableInserter::copyTunableFactor(
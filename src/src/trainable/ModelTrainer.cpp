@@ -5,13 +5,19 @@
  * report any bug to andrecasa91@gmail.com.
  **/
 
-#ifdef EFG_LEARNING_ENABLED
-
 #include <EasyFactorGraph/trainable/ModelTrainer.h>
+
+#ifdef EFG_LEARNING_ENABLED
 #include <TrainingTools/ParametersAware.h>
+#endif
+
+#include <functional>
+#include <math.h>
+#include <optional>
 
 namespace EFG::train {
 namespace {
+#ifdef EFG_LEARNING_ENABLED
 ::train::Vect to_Vect(const std::vector<float> &subject) {
   ::train::Vect result(subject.size());
   for (std::size_t k = 0; k < subject.size(); ++k) {
@@ -28,58 +34,148 @@ std::vector<float> to_vector(const ::train::Vect &subject) {
   }
   return result;
 }
+#endif
 
 struct TrainSetWrapper {
-  TrainSetWrapper(const TrainSet &source, float percentage)
-      : source(source), percentage(percentage) {
-    combinations = std::make_unique<TrainSet::Iterator>(source, 1.f);
+  TrainSetWrapper(const TrainSet &source, const TrainInfo &info)
+      : combinations{source.makeIterator()} {
+    if (1.f != info.stochastic_percentage) {
+      scheduler.emplace(source, info.stochastic_percentage, info.seed);
+    }
   }
 
-  const TrainSet &source;
-  float percentage;
+  TrainSet::Iterator combinations;
+  std::optional<MinibatchScheduler> scheduler;
 
-  mutable std::unique_ptr<TrainSet::Iterator> combinations;
-
-  const TrainSet::Iterator &get() const {
-    if (1.f != percentage) {
-      combinations = std::make_unique<TrainSet::Iterator>(source, percentage);
+  const TrainSet::Iterator &get() {
+    if (scheduler.has_value()) {
+      combinations = scheduler->next();
     }
-    return *combinations;
+    return combinations;
   }
 };
 } // namespace
 
-class FactorsTunableGetter::ModelWrapper : public ::train::ParametersAware {
+class FactorsTunableGetter::ModelWrapper {
 public:
   ModelWrapper(FactorsTunableGetter &subject, const TrainSet &train_set,
                const TrainInfo &info)
-      : subject(subject),
-        train_set(TrainSetWrapper{train_set, info.stochastic_percentage}),
-        activator(subject, info.threads) {}
+      : subject(subject), activator(subject, info.threads) {
+    auto wrapper = std::make_shared<TrainSetWrapper>(train_set, info);
+    if (info.objective == TrainObjective::PSEUDO_LIKELIHOOD) {
+      gradient = [&subject, wrapper]() {
+        return subject.getPseudoLikelihoodGradient_(wrapper->get());
+      };
+      return;
+    }
+    gradient = [&subject, wrapper]() {
+      return subject.getWeightsGradient_(wrapper->get());
+    };
+  }
+
+  ModelWrapper(FactorsTunableGetter &subject,
+               TrainSetSource &train_set_source, const TrainInfo &info)
+      : subject(subject), activator(subject, info.threads) {
+    if (info.objective == TrainObjective::PSEUDO_LIKELIHOOD) {
+      gradient = [&subject, &train_set_source]() {
+        return subject.getPseudoLikelihoodGradientFromSource_(
+            train_set_source);
+      };
+      return;
+    }
+    gradient = [&subject, &train_set_source]() {
+      return subject.getWeightsGradientFromSource_(train_set_source);
+    };
+  }
+
+  FactorsTunableGetter &getSubject() const { return subject; }
+
+  std::vector<float> getGradient() const { return gradient(); }
+
+private:
+  FactorsTunableGetter &subject;
+  std::function<std::vector<float>()> gradient;
+  strct::PoolAware::ScopedPoolActivator activator;
+};
+
+namespace {
+void optimize(const FactorsTunableGetter::ModelWrapper &wrapper,
+              Optimizer &optimizer) {
+  auto &subject = wrapper.getSubject();
+  optimizer.reset(subject.getWeights().size());
+  for (std::size_t iter = 0; iter < optimizer.getMaxIterations(); ++iter) {
+    const auto gradient = wrapper.getGradient();
+    bool converged = true;
+    for (float component : gradient) {
+      if (fabsf(component) > optimizer.getTolerance()) {
+        converged = false;
+        break;
+      }
+    }
+    if (converged) {
+      break;
+    }
+    const Span<const float> gradient_span{gradient.data(), gradient.size()};
+    if (subject.updateWeights([&](Span<float> weights) {
+          optimizer.step(weights, gradient_span);
+        })) {
+      continue;
+    }
+    // the weights are scattered: updated on a copy
+    auto weights = subject.getWeights();
+    optimizer.step(Span<float>{weights.data(), weights.size()}, gradient_span);
+    subject.setWeights(weights);
+  }
+}
+
+#ifdef EFG_LEARNING_ENABLED
+class ParametersAwareWrapper : public ::train::ParametersAware {
+public:
+  ParametersAwareWrapper(const FactorsTunableGetter::ModelWrapper &wrapper)
+      : wrapper{wrapper} {}
 
   ::train::Vect getParameters() const final {
-    return to_Vect(subject.getWeights());
+    return to_Vect(wrapper.getSubject().getWeights());
   };
   void setParameters(const ::train::Vect &w) final {
-    subject.setWeights(to_vector(w));
+    wrapper.getSubject().setWeights(to_vector(w));
   }
 
   ::train::Vect getGradient() const final {
-    return -to_Vect(subject.getWeightsGradient_(train_set.get()));
+    return -to_Vect(wrapper.getGradient());
   }
 
 private:
-  FactorsTunableGetter &subject;
-  TrainSetWrapper train_set;
-  strct::PoolAware::ScopedPoolActivator activator;
+  const FactorsTunableGetter::ModelWrapper &wrapper;
 };
+#endif
+} // namespace
 
-void train_model(FactorsTunableGetter &subject, ::train::Trainer &trainer,
+void train_model(FactorsTunableGetter &subject, Optimizer &optimizer,
                  const TrainSet &train_set, const TrainInfo &info) {
   FactorsTunableGetter::ModelWrapper wrapper(subject, train_set, info);
-  trainer.train(wrapper);
+  optimize(wrapper, optimizer);
 }
 
-} // namespace EFG::train
+void train_model(FactorsTunableGetter &subject, Optimizer &optimizer,
+                 TrainSetSource &train_set_source, const TrainInfo &info) {
+  FactorsTunableGetter::ModelWrapper wrapper(subject, train_set_source, info);
+  optimize(wrapper, optimizer);
+}
+
+#ifdef EFG_LEARNING_ENABLED
+void train_model(FactorsTunableGetter &subject, ::train::Trainer &trainer,
+                 const TrainSet &train_set, const TrainInfo &info) {
+  FactorsTunableGetter::ModelWrapper wrapper(subject, train_set, info);
+  ParametersAwareWrapper parameters_aware(wrapper);
+  trainer.train(parameters_aware);
+}
 
+void train_model(FactorsTunableGetter &subject, ::train::Trainer &trainer,
+                 TrainSetSource &train_set_source, const TrainInfo &info) {
+  FactorsTunableGetter::ModelWrapper wrapper(subject, train_set_source, info);
+  ParametersAwareWrapper parameters_aware(wrapper);
+  trainer.train(parameters_aware);
+}
 #endif
+} // namespace EFG::train
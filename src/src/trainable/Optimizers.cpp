@@ -0,0 +1,186 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#include <EasyFactorGraph/Error.h>
+#include <EasyFactorGraph/trainable/Optimizers.h>
+
+#include <math.h>
+
+namespace EFG::train {
+namespace {
+template <typename VectorA, typename VectorB>
+float dot(const VectorA &a, const VectorB &b) {
+  double result = 0;
+  for (std::size_t k = 0; k < a.size(); ++k) {
+    result += static_cast<double>(a[k]) * static_cast<double>(b[k]);
+  }
+  return static_cast<float>(result);
+}
+
+void check_positive(float value, const std::string &name) {
+  if (value <= 0) {
+    throw Error::make(name, " should be positive");
+  }
+}
+
+void check_rate(float value, const std::string &name) {
+  if ((value < 0) || (value >= 1.f)) {
+    throw Error::make(name, " should be in [0, 1)");
+  }
+}
+
+void check_sizes(Span<float> weights, Span<const float> gradient,
+                 std::size_t size) {
+  if ((weights.size() != size) || (gradient.size() != size)) {
+    throw Error{"Weights or gradient of inconsistent size"};
+  }
+}
+} // namespace
+
+void Optimizer::setMaxIterations(std::size_t iterations) {
+  if (iterations == 0) {
+    throw Error{"At least 1 iteration should be done"};
+  }
+  max_iterations = iterations;
+}
+
+void Optimizer::setTolerance(float tolerance) {
+  if (tolerance < 0) {
+    throw Error{"Tolerance can't be negative"};
+  }
+  this->tolerance = tolerance;
+}
+
+SGD::SGD(float learning_rate, float momentum)
+    : learning_rate{learning_rate}, momentum{momentum} {
+  check_positive(learning_rate, "learning rate");
+  check_rate(momentum, "momentum");
+}
+
+void SGD::reset(std::size_t size) { velocity.assign(size, 0); }
+
+void SGD::step(Span<float> weights, Span<const float> gradient) {
+  check_sizes(weights, gradient, velocity.size());
+  for (std::size_t k = 0; k < weights.size(); ++k) {
+    velocity[k] = momentum * velocity[k] + learning_rate * gradient[k];
+    weights[k] += velocity[k];
+  }
+}
+
+Adam::Adam(float learning_rate, float beta1, float beta2, float epsilon)
+    : learning_rate{learning_rate}, beta1{beta1}, beta2{beta2},
+      epsilon{epsilon} {
+  check_positive(learning_rate, "learning rate");
+  check_positive(epsilon, "epsilon");
+  check_rate(beta1, "beta1");
+  check_rate(beta2, "beta2");
+}
+
+void Adam::reset(std::size_t size) {
+  first_moments.assign(size, 0);
+  second_moments.assign(size, 0);
+  beta1_power = 1.f;
+  beta2_power = 1.f;
+}
+
+void Adam::step(Span<float> weights, Span<const float> gradient) {
+  check_sizes(weights, gradient, first_moments.size());
+  beta1_power *= beta1;
+  beta2_power *= beta2;
+  const float first_correction = 1.f - beta1_power;
+  const float second_correction = 1.f - beta2_power;
+  for (std::size_t k = 0; k < weights.size(); ++k) {
+    const float g = gradient[k];
+    first_moments[k] = beta1 * first_moments[k] + (1.f - beta1) * g;
+    second_moments[k] = beta2 * second_moments[k] + (1.f - beta2) * g * g;
+    weights[k] += learning_rate * (first_moments[k] / first_correction) /
+                  (sqrtf(second_moments[k] / second_correction) + epsilon);
+  }
+}
+
+LBFGS::LBFGS(std::size_t memory, float learning_rate, float max_step)
+    : memory{memory}, learning_rate{learning_rate}, max_step{max_step} {
+  if (memory == 0) {
+    throw Error{"L-BFGS memory should be at least 1"};
+  }
+  check_positive(learning_rate, "learning rate");
+  check_positive(max_step, "max step");
+}
+
+void LBFGS::reset(std::size_t size) {
+  corrections.clear();
+  previous_weights.assign(size, 0);
+  previous_gradient.clear();
+}
+
+void LBFGS::step(Span<float> weights, Span<const float> gradient) {
+  check_sizes(weights, gradient, previous_weights.size());
+  const std::size_t size = weights.size();
+  if (!previous_gradient.empty()) {
+    // the minimized function is the negated likelihood, whose gradient is
+    // the opposite of the passed one
+    Correction correction;
+    correction.s.resize(size);
+    correction.y.resize(size);
+    for (std::size_t k = 0; k < size; ++k) {
+      correction.s[k] = weights[k] - previous_weights[k];
+      correction.y[k] = previous_gradient[k] - gradient[k];
+    }
+    const float curvature = dot(correction.s, correction.y);
+    if (curvature > 1e-10f) {
+      correction.rho = 1.f / curvature;
+      if (corrections.size() == memory) {
+        corrections.pop_front();
+      }
+      corrections.emplace_back(std::move(correction));
+    } else {
+      corrections.clear();
+    }
+  }
+  previous_weights.assign(weights.begin(), weights.end());
+  previous_gradient.assign(gradient.begin(), gradient.end());
+
+  // two loops recursion, computing the ascent direction
+  std::vector<float> direction{gradient.begin(), gradient.end()};
+  std::vector<float> alphas(corrections.size());
+  for (std::size_t c = corrections.size(); c > 0; --c) {
+    const auto &correction = corrections[c - 1];
+    alphas[c - 1] = correction.rho * dot(correction.s, direction);
+    for (std::size_t k = 0; k < size; ++k) {
+      direction[k] -= alphas[c - 1] * correction.y[k];
+    }
+  }
+  if (!corrections.empty()) {
+    const auto &last = corrections.back();
+    const float gamma = dot(last.s, last.y) / dot(last.y, last.y);
+    for (auto &component : direction) {
+      component *= gamma;
+    }
+  }
+  for (std::size_t c = 0; c < corrections.size(); ++c) {
+    const auto &correction = corrections[c];
+    const float beta = correction.rho * dot(correction.y, direction);
+    for (std::size_t k = 0; k < size; ++k) {
+      direction[k] += (alphas[c] - beta) * correction.s[k];
+    }
+  }
+  if (dot(direction, gradient) <= 0) {
+    // not an ascent direction
+    corrections.clear();
+    direction.assign(gradient.begin(), gradient.end());
+  }
+
+  float scale = learning_rate;
+  const float norm = sqrtf(dot(direction, direction)) * learning_rate;
+  if (norm > max_step) {
+    scale *= max_step / norm;
+  }
+  for (std::size_t k = 0; k < size; ++k) {
+    weights[k] += scale * direction[k];
+  }
+}
+} // namespace EFG::train
@@ -0,0 +1,170 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#include <EasyFactorGraph/categoric/Odometer.h>
+#include <EasyFactorGraph/trainable/FactorsTunableManager.h>
+#include <EasyFactorGraph/trainable/tuners/TunerVisitor.h>
+
+#include <exception>
+#include <unordered_map>
+
+namespace EFG::train {
+namespace {
+struct LocalFactor {
+  factor::ImageFinder finder;
+  // the tuner handling the weight of the factor, when tunable
+  std::optional<std::size_t> tuner;
+};
+
+// a variable predicted from the values of its neighbours
+struct LocalTerm {
+  // position of the variable in the samples
+  std::size_t position;
+  std::size_t size;
+  // all the factors involving the variable
+  std::vector<LocalFactor> factors;
+};
+
+// accumulates in gradient the contributions of the samples in [begin, end)
+void accumulate(const std::vector<LocalTerm> &terms,
+                const TrainSet::Iterator &train_set_combinations,
+                std::size_t begin, std::size_t end,
+                std::vector<float> &gradient) {
+  std::vector<std::size_t> combination;
+  std::vector<float> probabilities;
+  train_set_combinations.forEachSample(
+      begin, end,
+      [&](const categoric::CombinationMatrix::Row &sample,
+          std::size_t count) {
+        combination.resize(sample.size());
+        for (std::size_t k = 0; k < sample.size(); ++k) {
+          combination[k] = sample[k];
+        }
+        const float weight = static_cast<float>(count);
+        for (const auto &term : terms) {
+          const std::size_t observed = combination[term.position];
+          // conditioned distribution of the variable, given the neighbours
+          probabilities.assign(term.size, 1.f);
+          float sum = 0;
+          for (std::size_t v = 0; v < term.size; ++v) {
+            combination[term.position] = v;
+            for (const auto &local : term.factors) {
+              probabilities[v] *= local.finder.findTransformed(combination);
+            }
+            sum += probabilities[v];
+          }
+          if (sum == 0) {
+            combination[term.position] = observed;
+            continue;
+          }
+          for (const auto &local : term.factors) {
+            if (!local.tuner.has_value()) {
+              continue;
+            }
+            float expected = 0;
+            for (std::size_t v = 0; v < term.size; ++v) {
+              combination[term.position] = v;
+              expected +=
+                  probabilities[v] * local.finder.findImage(combination);
+            }
+            combination[term.position] = observed;
+            gradient[local.tuner.value()] +=
+                weight * (local.finder.findImage(combination) - expected / sum);
+          }
+          combination[term.position] = observed;
+        }
+      });
+}
+} // namespace
+
+std::vector<float> FactorsTunableGetter::getPseudoLikelihoodGradient_(
+    const TrainSet::Iterator &train_set_combinations) {
+  const auto &vars = getAllVariables();
+  std::unordered_map<const factor::Immutable *, std::size_t> tuners_of_factors;
+  for (std::size_t t = 0; t < tuners.size(); ++t) {
+    visitTuner(
+        tuners[t].get(),
+        [&](const BaseTuner &base) {
+          tuners_of_factors.emplace(&base.getFactor(), t);
+        },
+        [&](const CompositeTuner &composite) {
+          for (const auto &element : composite.getElements()) {
+            tuners_of_factors.emplace(
+                &static_cast<const BaseTuner &>(*element).getFactor(), t);
+          }
+        });
+  }
+
+  std::vector<LocalTerm> terms;
+  const auto &state = this->state();
+  for (std::size_t position = 0; position < vars.size(); ++position) {
+    const auto &var = vars[position];
+    if (state.evidences.find(var) != state.evidences.end()) {
+      // evidences are not predicted, but only used to predict the others
+      continue;
+    }
+    auto &term = terms.emplace_back(LocalTerm{position, var->size(), {}});
+    auto add_factor = [&](const factor::ImmutablePtr &factor) {
+      std::optional<std::size_t> tuner;
+      if (auto it = tuners_of_factors.find(factor.get());
+          it != tuners_of_factors.end()) {
+        tuner = it->second;
+      }
+      term.factors.push_back(LocalFactor{factor->makeFinder(vars), tuner});
+    };
+    const auto &node = *state.nodes.find(var)->second;
+    for (const auto &factor : node.unary_factors) {
+      add_factor(factor);
+    }
+    for (const auto &[_, connection] : node.active_connections) {
+      add_factor(connection.factor);
+    }
+    for (const auto &[_, connection] : node.disabled_connections) {
+      add_factor(connection.factor);
+    }
+  }
+
+  std::vector<float> result(tuners.size(), 0);
+  const auto chunks = categoric::partition_domain(
+      train_set_combinations.entries(), getPool().size());
+  if (chunks.size() == 1) {
+    accumulate(terms, train_set_combinations, 0,
+               train_set_combinations.entries(), result);
+  } else {
+    std::vector<std::vector<float>> chunks_gradient(
+        chunks.size(), std::vector<float>(tuners.size(), 0));
+    std::vector<std::exception_ptr> errors(chunks.size());
+    strct::Tasks tasks;
+    for (std::size_t c = 0; c < chunks.size(); ++c) {
+      tasks.emplace_back([&, c](const std::size_t) {
+        try {
+          accumulate(terms, train_set_combinations, chunks[c].first,
+                     chunks[c].second, chunks_gradient[c]);
+        } catch (...) {
+          errors[c] = std::current_exception();
+        }
+      });
+    }
+    getPool().parallelFor(tasks);
+    for (const auto &error : errors) {
+      if (error != nullptr) {
+        std::rethrow_exception(error);
+      }
+    }
+    for (const auto &chunk_gradient : chunks_gradient) {
+      for (std::size_t t = 0; t < result.size(); ++t) {
+        result[t] += chunk_gradient[t];
+      }
+    }
+  }
+  const float coeff = 1.f / static_cast<float>(train_set_combinations.size());
+  for (auto &value : result) {
+    value *= coeff;
+  }
+  return result;
+}
+} // namespace EFG::train
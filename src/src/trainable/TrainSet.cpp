@@ -8,41 +8,123 @@
 #include <EasyFactorGraph/Error.h>
 #include <EasyFactorGraph/trainable/TrainSet.h>
 
+#include <algorithm>
+#include <future>
 #include <math.h>
+#include <mutex>
+#include <unordered_map>
 
 namespace EFG::train {
-TrainSet::TrainSet(const std::vector<std::vector<std::size_t>> &combinations) {
+namespace {
+void check_combinations(const categoric::CombinationMatrix &combinations) {
   if (combinations.empty()) {
     throw Error("empty train set");
   }
-  const std::size_t size = combinations.front().size();
-  for (const auto &combination : combinations) {
-    if ((0 == combination.size()) || (size != combination.size())) {
-      throw Error("invalid train set");
-    }
+  if (0 == combinations.columns()) {
+    throw Error("invalid train set");
   }
-  this->combinations = std::make_shared<const Combinations>(combinations);
 }
 
-TrainSet::Iterator::Iterator(const TrainSet &subject, float percentage) {
-  this->combinations = subject.combinations;
-  if (1.f == percentage) {
-    return;
-  }
+std::size_t subset_size(std::size_t samples, float percentage) {
   if ((percentage <= 0) || (percentage > 1.f)) {
     throw Error::make(percentage,
                       " is an invalid percentage for a TrainSet Iterator");
   }
-  int subset_size =
-      std::max(0, static_cast<int>(floorf(percentage * combinations->size())));
-  auto &subset = combinations_subset.emplace();
-  subset.reserve(subset_size);
-  for (int k = 0; k < subset_size; ++k) {
-    int sampled_pos = rand() % combinations->size();
-    subset.push_back(sampled_pos);
+  return std::max<std::size_t>(
+      1, static_cast<std::size_t>(floorf(percentage * samples)));
+}
+
+} // namespace
+
+struct TrainSet::Distributions {
+  // only guards the map: distributions are computed outside of it
+  std::mutex mtx;
+  // keys are the positions of the variables, followed by their sizes. Values
+  // are ready as soon as the first thread asking for them computes them.
+  std::unordered_map<std::vector<std::size_t>,
+                     std::shared_future<std::vector<float>>, CombinationHasher>
+      computed;
+};
+
+TrainSet::TrainSet(categoric::CombinationMatrix combinations, bool compact) {
+  check_combinations(combinations);
+  distributions = std::make_shared<Distributions>();
+  samples = combinations.size();
+  this->counts = std::make_shared<const std::vector<std::size_t>>();
+  if (!compact) {
+    this->combinations = std::make_shared<const categoric::CombinationMatrix>(
+        std::move(combinations));
+    return;
+  }
+  // rows of the same matrix are equal when their bytes are equal
+  categoric::CombinationMatrix distinct{combinations.columns()};
+  std::vector<std::size_t> distinct_counts;
+  std::unordered_map<std::string_view, std::size_t> positions;
+  for (const auto combination : combinations) {
+    auto [it, added] =
+        positions.emplace(combination.bytes(), distinct_counts.size());
+    if (added) {
+      distinct.push_back(combination);
+      distinct_counts.push_back(1);
+    } else {
+      ++distinct_counts[it->second];
+    }
   }
+  this->combinations =
+      std::make_shared<const categoric::CombinationMatrix>(std::move(distinct));
+  this->counts = std::make_shared<const std::vector<std::size_t>>(
+      std::move(distinct_counts));
 }
 
+TrainSet::TrainSet(categoric::CombinationMatrix combinations,
+                   const std::vector<std::size_t> &counts) {
+  check_combinations(combinations);
+  distributions = std::make_shared<Distributions>();
+  if (counts.size() != combinations.size()) {
+    throw Error("invalid train set counts");
+  }
+  samples = 0;
+  for (auto count : counts) {
+    if (0 == count) {
+      throw Error("invalid train set counts");
+    }
+    samples += count;
+  }
+  this->combinations = std::make_shared<const categoric::CombinationMatrix>(
+      std::move(combinations));
+  this->counts = std::make_shared<const std::vector<std::size_t>>(counts);
+}
+
+TrainSet::Iterator::Iterator(const TrainSet &subject, float percentage)
+    : combinations{subject.combinations}, counts{subject.counts},
+      samples{subject.samples}, distributions{subject.distributions} {
+  if (1.f == percentage) {
+    return;
+  }
+  distributions = std::make_shared<Distributions>();
+  subset_end = subset_size(samples, percentage);
+  SamplesUrn urn{combinations->size(), counts};
+  urn.refill();
+  thread_local std::mt19937_64 engine{std::random_device{}()};
+  std::vector<std::size_t> positions;
+  positions.reserve(subset_end);
+  for (std::size_t k = 0; k < subset_end; ++k) {
+    positions.push_back(urn.draw(engine));
+  }
+  subset = std::make_shared<const std::vector<std::size_t>>(
+      std::move(positions));
+}
+
+TrainSet::Iterator::Iterator(
+    const TrainSet &subject,
+    std::shared_ptr<const std::vector<std::size_t>> subset,
+    std::size_t subset_begin, std::size_t subset_end)
+    : combinations{subject.combinations}, counts{subject.counts},
+      samples{subject.samples},
+      distributions{std::make_shared<Distributions>()},
+      subset{std::move(subset)}, subset_begin{subset_begin},
+      subset_end{subset_end} {}
+
 TrainSet::Iterator TrainSet::makeIterator() const {
   return Iterator{*this, 1.f};
 }
@@ -52,7 +134,147 @@ TrainSet::Iterator TrainSet::makeSubSetIterator(float percentage) const {
 }
 
 std::size_t TrainSet::Iterator::size() const {
-  return combinations_subset.has_value() ? combinations_subset->size()
-                                         : combinations->size();
+  return (subset != nullptr) ? subset_end - subset_begin : samples;
+}
+
+std::size_t TrainSet::Iterator::entries() const {
+  return (subset != nullptr) ? subset_end - subset_begin
+                             : combinations->size();
+}
+
+SamplesUrn::SamplesUrn(std::size_t combinations,
+                       std::shared_ptr<const std::vector<std::size_t>> counts)
+    : combinations{combinations}, counts{std::move(counts)} {
+  highest_step = 1;
+  while (highest_step * 2 <= combinations) {
+    highest_step *= 2;
+  }
+}
+
+void SamplesUrn::refill() {
+  tree.assign(combinations + 1, 1);
+  tree.front() = 0;
+  if (!counts->empty()) {
+    std::copy(counts->begin(), counts->end(), tree.begin() + 1);
+  }
+  remaining_ = 0;
+  // linear time construction of the Fenwick tree
+  for (std::size_t i = 1; i <= combinations; ++i) {
+    remaining_ += counts->empty() ? 1 : (*counts)[i - 1];
+    const std::size_t parent = i + (i & (~i + 1));
+    if (parent <= combinations) {
+      tree[parent] += tree[i];
+    }
+  }
+}
+
+std::size_t SamplesUrn::draw(std::mt19937_64 &engine) {
+  if (remaining_ == 0) {
+    throw Error{"No samples left in the urn"};
+  }
+  std::uniform_int_distribution<std::size_t> distribution{0, remaining_ - 1};
+  std::size_t target = distribution(engine);
+  // search for the combination whose cumulated count exceeds the target
+  std::size_t position = 0;
+  for (std::size_t step = highest_step; step > 0; step /= 2) {
+    const std::size_t next = position + step;
+    if ((next <= combinations) && (tree[next] <= target)) {
+      position = next;
+      target -= tree[next];
+    }
+  }
+  for (std::size_t i = position + 1; i <= combinations; i += i & (~i + 1)) {
+    --tree[i];
+  }
+  --remaining_;
+  return position;
+}
+
+MinibatchScheduler::MinibatchScheduler(const TrainSet &subject,
+                                       float percentage,
+                                       std::optional<std::size_t> seed)
+    : subject{subject},
+      batch_size{subset_size(subject.size(), percentage)},
+      engine{seed.has_value() ? seed.value() : std::random_device{}()},
+      urn{subject.combinations->size(), subject.counts} {}
+
+TrainSet::Iterator MinibatchScheduler::next() {
+  if (urn.remaining() == 0) {
+    urn.refill();
+    ++epoch;
+  }
+  // every batch owns its positions: nothing is shared with the previous
+  // batches, which may be still alive
+  const std::size_t size = std::min(batch_size, urn.remaining());
+  auto positions = std::make_shared<std::vector<std::size_t>>();
+  positions->reserve(size);
+  for (std::size_t k = 0; k < size; ++k) {
+    positions->push_back(urn.draw(engine));
+  }
+  return TrainSet::Iterator{subject, std::move(positions), 0, size};
+}
+
+const std::vector<float> &TrainSet::Iterator::getEmpiricalDistribution(
+    const std::vector<std::size_t> &positions,
+    const std::vector<std::size_t> &sizes) const {
+  std::vector<std::size_t> key = positions;
+  key.insert(key.end(), sizes.begin(), sizes.end());
+  std::promise<std::vector<float>> promise;
+  std::shared_future<std::vector<float>> result;
+  bool to_compute = false;
+  {
+    std::scoped_lock lock(distributions->mtx);
+    auto [it, added] = distributions->computed.emplace(
+        key, std::shared_future<std::vector<float>>{});
+    if (added) {
+      it->second = promise.get_future().share();
+      to_compute = true;
+    }
+    result = it->second;
+  }
+  if (!to_compute) {
+    // possibly waits for the thread computing it
+    return result.get();
+  }
+  try {
+    std::vector<std::size_t> strides(sizes.size());
+    std::size_t domain_size = 1;
+    for (std::size_t k = sizes.size(); k > 0; --k) {
+      strides[k - 1] = domain_size;
+      domain_size *= sizes[k - 1];
+    }
+    std::vector<std::size_t> occurrences(domain_size, 0);
+    forEachSample([&](const categoric::CombinationMatrix::Row &comb,
+                      std::size_t weight) {
+      std::size_t flat = 0;
+      for (std::size_t k = 0; k < positions.size(); ++k) {
+        const std::size_t value = comb[positions[k]];
+        if (sizes[k] <= value) {
+          throw Error::make(value, "is an invalid value for a variable of size",
+                            sizes[k]);
+        }
+        flat += value * strides[k];
+      }
+      occurrences[flat] += weight;
+    });
+    const float coeff = 1.f / static_cast<float>(size());
+    std::vector<float> distribution;
+    distribution.reserve(domain_size);
+    for (auto occurrence : occurrences) {
+      distribution.push_back(coeff * static_cast<float>(occurrence));
+    }
+    promise.set_value(std::move(distribution));
+  } catch (...) {
+    {
+      // the next request will try again
+      std::scoped_lock lock(distributions->mtx);
+      distributions->computed.erase(key);
+    }
+    // threads already waiting receive the same error
+    promise.set_exception(std::current_exception());
+    throw;
+  }
+  // the shared state is kept alive by the cache
+  return result.get();
 }
 } // namespace EFG::train
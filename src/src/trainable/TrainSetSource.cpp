@@ -0,0 +1,76 @@
+/**
+ * Author:    Andrea Casalino
+ * Created:   19.10.2026
+ *
+ * report any bug to andrecasa91@gmail.com.
+ **/
+
+#include <EasyFactorGraph/Error.h>
+#include <EasyFactorGraph/trainable/TrainSetSource.h>
+
+namespace EFG::train {
+GeneratedSource::GeneratedSource(Generator generator, std::size_t chunks)
+    : generator{std::move(generator)}, chunks{chunks} {
+  if (!this->generator) {
+    throw Error{"null generator"};
+  }
+}
+
+std::optional<categoric::CombinationMatrix> GeneratedSource::nextChunk() {
+  if (next_chunk == chunks) {
+    return std::nullopt;
+  }
+  return generator(next_chunk++);
+}
+
+ReadAheadSource::ReadAheadSource(std::unique_ptr<TrainSetSource> source)
+    : source{std::move(source)} {
+  if (this->source == nullptr) {
+    throw Error{"null source"};
+  }
+  readAhead();
+}
+
+ReadAheadSource::~ReadAheadSource() {
+  if (next_chunk.valid()) {
+    next_chunk.wait();
+  }
+}
+
+void ReadAheadSource::readAhead() {
+  next_chunk = std::async(std::launch::async, [source = source.get()]() {
+    return source->nextChunk();
+  });
+}
+
+std::optional<categoric::CombinationMatrix> ReadAheadSource::nextChunk() {
+  std::optional<categoric::CombinationMatrix> result;
+  try {
+    // re-throws in case the background retrieval failed
+    result = next_chunk.get();
+  } catch (...) {
+    // keeps on failing until rewind, instead of leaving an invalid future
+    std::promise<std::optional<categoric::CombinationMatrix>> failed;
+    failed.set_exception(std::current_exception());
+    next_chunk = failed.get_future();
+    throw;
+  }
+  if (result.has_value()) {
+    readAhead();
+  } else {
+    // keeps on returning nullopt until rewind
+    std::promise<std::optional<categoric::CombinationMatrix>> exhausted;
+    exhausted.set_value(std::nullopt);
+    next_chunk = exhausted.get_future();
+  }
+  return result;
+}
+
+void ReadAheadSource::rewind() {
+  if (next_chunk.valid()) {
+    next_chunk.wait();
+  }
+  source->rewind();
+  readAhead();
+}
+} // namespace EFG::train
@@ -5,24 +5,30 @@
  * report any bug to andrecasa91@gmail.com.
  **/
 
+#include <EasyFactorGraph/Error.h>
 #include <EasyFactorGraph/trainable/tuners/BaseTuner.h>
 
+#include <algorithm>
+
 namespace EFG::train {
 BaseTuner::BaseTuner(const std::shared_ptr<factor::FactorExponential> &factor,
                      const categoric::VariablesSoup &variables_in_model)
-    : factor(factor), finder(factor->makeFinder(variables_in_model)) {}
+    : factor(factor) {
+  for (const auto &var : factor->function().vars().getVariables()) {
+    auto it = std::find_if(
+        variables_in_model.begin(), variables_in_model.end(),
+        [&var](const categoric::VariablePtr &other) { return *other == *var; });
+    if (it == variables_in_model.end()) {
+      throw Error::make(var->name(), "is not part of the model");
+    }
+    positions_in_model.push_back(
+        std::distance(variables_in_model.begin(), it));
+    sizes.push_back(var->size());
+  }
+}
 
 float BaseTuner::getGradientAlpha(const TrainSet::Iterator &iter) {
-  if (!alpha_part.has_value() || (alpha_part->train_set_iterator != &iter)) {
-    auto &[iter_ptr, val] = alpha_part.emplace();
-    val = 0;
-    const float coeff = 1.f / static_cast<float>(iter.size());
-    iter.forEachSample([&finder = this->finder, &value = val,
-                        &coeff](const std::vector<std::size_t> &comb) {
-      value += coeff * finder.findImage(comb);
-    });
-  }
-  return alpha_part->value;
+  return dotProduct(iter.getEmpiricalDistribution(positions_in_model, sizes));
 }
 
 float BaseTuner::dotProduct(const std::vector<float> &prob) const {
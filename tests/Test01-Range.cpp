@@ -1,9 +1,13 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
 
+#include <EasyFactorGraph/Error.h>
+#include <EasyFactorGraph/categoric/CombinationMatrix.h>
 #include <EasyFactorGraph/categoric/GroupRange.h>
+#include <EasyFactorGraph/categoric/Odometer.h>
 
 #include <algorithm>
+#include <thread>
 
 namespace EFG::test {
 using namespace categoric;
@@ -68,4 +72,152 @@ TEST_CASE("testing for_each_combination", "[range]") {
               {2, 2, 0}, {2, 2, 1}, {2, 3, 0}, {2, 3, 1}});
   }
 }
+TEST_CASE("testing odometer", "[range]") {
+  const std::vector<std::size_t> sizes = {3, 4, 2};
+  GroupRange range(
+      {make_variable(3, "A"), make_variable(4, "B"), make_variable(2, "C")});
+  const auto expected = all_combinations_in_range(range);
+
+  SECTION("entire domain") {
+    Odometer odometer(sizes);
+    std::vector<std::vector<std::size_t>> got;
+    std::size_t flat = 0;
+    for_each_combination(odometer, [&](const auto &comb) {
+      CHECK(odometer.flat() == flat++);
+      got.emplace_back(comb);
+    });
+    CHECK(got == expected);
+  }
+
+  SECTION("seek") {
+    Odometer odometer(sizes);
+    odometer.seek(13);
+    CHECK(odometer.combination() == expected[13]);
+    odometer.next();
+    CHECK(odometer.combination() == expected[14]);
+  }
+
+  SECTION("partitioned domain") {
+    auto chunks = GENERATE(1, 2, 5, 24, 30);
+    const auto partitions = partition_domain(expected.size(), chunks);
+    CHECK(partitions.size() == std::min<std::size_t>(chunks, expected.size()));
+    std::vector<std::vector<std::size_t>> got;
+    for (const auto &[begin, end] : partitions) {
+      Odometer odometer(sizes, begin, end);
+      for_each_combination(odometer,
+                           [&got](const auto &comb) { got.emplace_back(comb); });
+    }
+    CHECK(got == expected);
+  }
+
+  SECTION("invalid range") {
+    CHECK_THROWS_AS(Odometer(sizes, 3, 2), Error);
+    CHECK_THROWS_AS(Odometer(sizes, 0, 25), Error);
+  }
+}
+
+TEST_CASE("interned variables names", "[range]") {
+  auto A = make_variable(2, "A");
+  auto A_again = make_variable(2, "A");
+  auto A_bigger = make_variable(3, "A");
+  auto B = make_variable(2, "B");
+
+  CHECK(A->nameId() == A_again->nameId());
+  CHECK(A->nameId() == A_bigger->nameId());
+  CHECK(A->nameId() != B->nameId());
+
+  CHECK(*A == *A_again);
+  CHECK_FALSE(*A == *A_bigger);
+  CHECK_FALSE(*A == *B);
+
+  VariablesSet set{A, B};
+  CHECK(set.find(A_again) != set.end());
+  CHECK(set.find(A_bigger) == set.end());
+}
+
+TEST_CASE("interned names are released", "[range]") {
+  std::size_t released_id;
+  {
+    auto C = make_variable(2, "C_released");
+    released_id = C->nameId();
+  }
+  // no variable keeps the previous name alive
+  auto C_again = make_variable(2, "C_released");
+  CHECK(C_again->nameId() != released_id);
+
+  // interning from many threads
+  std::vector<VariablePtr> vars(8);
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < vars.size(); ++t) {
+    threads.emplace_back([&vars, t]() {
+      for (std::size_t k = 0; k < 100; ++k) {
+        auto temp = make_variable(2, "D_" + std::to_string(k % 5));
+      }
+      vars[t] = make_variable(2, "C_released");
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (const auto &var : vars) {
+    CHECK(var->nameId() == C_again->nameId());
+  }
+}
+
+TEST_CASE("combination matrix", "[range]") {
+  std::vector<std::vector<std::size_t>> combinations = {
+      {0, 1, 2}, {2, 1, 0}, {0, 1, 2}};
+  CombinationMatrix matrix{combinations};
+  CHECK(matrix.size() == 3);
+  CHECK(matrix.columns() == 3);
+  CHECK(matrix.width() == 1);
+  CHECK(matrix[0].bytes() == matrix[2].bytes());
+  CHECK(matrix[0].bytes() != matrix[1].bytes());
+
+  SECTION("values are widened when needed") {
+    auto [big, width] = GENERATE(table<std::size_t, std::size_t>(
+        {{255, 1}, {256, 2}, {70000, 4}, {5000000000, 8}}));
+    combinations.push_back({big, 0, 1});
+    matrix.push_back(combinations.back());
+    CHECK(matrix.width() == width);
+    CHECK(static_cast<std::vector<std::vector<std::size_t>>>(matrix) ==
+          combinations);
+  }
+
+  SECTION("rows iteration") {
+    std::vector<std::vector<std::size_t>> got;
+    for (const auto row : matrix) {
+      CHECK(row.size() == 3);
+      got.emplace_back(row);
+    }
+    CHECK(got == combinations);
+  }
+
+  SECTION("rows of the same matrix") {
+    for (std::size_t k = 0; k < 100; ++k) {
+      matrix.push_back(matrix[k % 2]);
+      combinations.push_back(combinations[k % 2]);
+    }
+    CHECK(static_cast<std::vector<std::vector<std::size_t>>>(matrix) ==
+          combinations);
+
+    // the matrix is the last owner of the aliased rows
+    auto buffer = std::make_shared<std::vector<std::uint8_t>>(
+        std::vector<std::uint8_t>{0, 1, 2, 2, 1, 0});
+    CombinationMatrix aliased{buffer, buffer->data(), 2, 3, 1};
+    buffer.reset();
+    aliased.push_back(aliased[1]);
+    CHECK(!aliased.isAliased());
+    CHECK(static_cast<std::vector<std::vector<std::size_t>>>(aliased) ==
+          std::vector<std::vector<std::size_t>>{
+              {0, 1, 2}, {2, 1, 0}, {2, 1, 0}});
+  }
+
+  SECTION("invalid combinations") {
+    CHECK_THROWS_AS(matrix.push_back(std::vector<std::size_t>{0, 1}), Error);
+    CHECK_THROWS_AS(
+        CombinationMatrix(std::vector<std::vector<std::size_t>>{{0, 1}, {0}}),
+        Error);
+  }
+}
 } // namespace EFG::test
@@ -7,6 +7,7 @@
 #include <EasyFactorGraph/categoric/GroupRange.h>
 #include <EasyFactorGraph/factor/Factor.h>
 #include <EasyFactorGraph/factor/FactorExponential.h>
+#include <EasyFactorGraph/factor/FixedArityFunction.h>
 
 #include "Utils.h"
 
@@ -196,4 +197,154 @@ TEST_CASE("bigger combination finder again", "[function]") {
   CHECK(finder.findImage(std::vector<std::size_t>{2, 2, 0, 1}) == 2.f);
   CHECK(finder.findImage(std::vector<std::size_t>{2, 1, 2, 1}) == 3.f);
 }
+TEST_CASE("batch combination finder", "[function]") {
+  auto A = make_variable(3, "A");
+  auto B = make_variable(3, "B");
+  auto C = make_variable(3, "C");
+
+  VariablesSoup bigger_group = {A, B, C};
+  Factor factor(Group{VariablesSoup{C, A}});
+  // few images, sparse factor
+  factor.set(std::vector<std::size_t>{0, 1}, 1.f);
+  factor.set(std::vector<std::size_t>{2, 1}, 2.f);
+
+  std::vector<std::vector<std::size_t>> combinations;
+  GroupRange range{Group{bigger_group}};
+  for_each_combination(range, [&combinations](const auto &comb) {
+    combinations.push_back(comb);
+  });
+
+  auto check_batch = [&]() {
+    auto finder = factor.makeFinder(bigger_group);
+    std::vector<float> images;
+    finder.findImages(combinations, images);
+    REQUIRE(images.size() == combinations.size());
+    for (std::size_t k = 0; k < combinations.size(); ++k) {
+      const auto &comb = combinations[k];
+      CHECK(images[k] == factor.function().findImage(
+                             std::vector<std::size_t>{comb[2], comb[0]}));
+      CHECK(images[k] == finder.findImage(comb));
+    }
+  };
+
+  SECTION("sparse") { check_batch(); }
+
+  SECTION("dense") {
+    setAllImages(factor, 0.5f);
+    factor.set(std::vector<std::size_t>{2, 0}, 3.f);
+    check_batch();
+  }
+}
+
+TEST_CASE("fixed arity function", "[function]") {
+  auto A = make_variable(3, "A");
+  auto B = make_variable(4, "B");
+
+  Factor factor(Group{VariablesSoup{A, B}});
+  factor.set(std::vector<std::size_t>{0, 1}, 1.f);
+  factor.set(std::vector<std::size_t>{2, 3}, 2.f);
+  factor.set(std::vector<std::size_t>{1, 0}, 3.f);
+
+  SECTION("raw images") {
+    const BinaryFunction subject{factor.function(), false};
+    CHECK(subject.strides() == BinaryFunction::Combination{4, 1});
+    std::size_t visited = 0;
+    subject.forEachCombination([&](const auto &comb, float img) {
+      CHECK(img == factor.function().findImage(
+                       std::vector<std::size_t>{comb[0], comb[1]}));
+      ++visited;
+    });
+    CHECK(visited == 12);
+  }
+
+  SECTION("transformed images") {
+    const float w = 1.5f;
+    FactorExponential factor_exp(factor, w);
+    const BinaryFunction subject{factor_exp.function(), true};
+    CHECK(subject.findImage({2, 3}) == expf(w * 2.f));
+    CHECK(subject.findImage({0, 0}) == 1.f);
+  }
+
+  SECTION("copy back") {
+    BinaryFunction subject{factor.function(), false};
+    subject.set({0, 0}, 5.f);
+    Function recipient(Group{VariablesSoup{A, B}});
+    subject.copyTo(recipient);
+    CHECK(recipient.findImage(std::vector<std::size_t>{0, 0}) == 5.f);
+    CHECK(recipient.findImage(std::vector<std::size_t>{2, 3}) == 2.f);
+  }
+
+  SECTION("wrong arity") {
+    CHECK_THROWS_AS(UnaryFunction(factor.function(), false), Error);
+  }
+}
+
+TEST_CASE("cached transformed images", "[function]") {
+  auto A = make_variable(2, "A");
+  auto B = make_variable(3, "B");
+
+  Factor factor(Group{VariablesSoup{A, B}});
+  factor.set(std::vector<std::size_t>{1, 2}, 2.f);
+  const float w = 0.5f;
+  FactorExponential factor_exp(factor, w);
+
+  auto check_images = [](const Function &function) {
+    const auto images = function.getTransformedImages();
+    REQUIRE(images->size() == 6);
+    auto it = images->begin();
+    bool all_equal = true;
+    function.forEachCombination<true>([&](const auto &, float img) {
+      all_equal = all_equal && (img == *it);
+      ++it;
+    });
+    CHECK(all_equal);
+    return images;
+  };
+
+  auto images = check_images(factor_exp.function());
+  CHECK(images->back() == expf(w * 2.f));
+  // computed only once
+  CHECK(images == factor_exp.function().getTransformedImages());
+
+  SECTION("weight changed") {
+    factor_exp.setWeight(2.f * w);
+    CHECK(check_images(factor_exp.function())->back() == expf(2.f * w * 2.f));
+  }
+
+  SECTION("image changed") {
+    check_images(factor.function());
+    factor.set(std::vector<std::size_t>{0, 0}, 3.f);
+    CHECK(check_images(factor.function())->front() == 3.f);
+  }
+}
+
+TEST_CASE("aliased dense images", "[function]") {
+  auto A = make_variable(2, "A");
+  auto B = make_variable(3, "B");
+
+  auto buffer = std::make_shared<std::vector<float>>(
+      std::vector<float>{0, 1.f, 2.f, 3.f, 4.f, 5.f});
+  Function subject{Group{VariablesSoup{A, B}}};
+  subject.aliasDenseImages(buffer, buffer->data());
+
+  const auto *images = subject.getDenseImages();
+  REQUIRE(images != nullptr);
+  CHECK(images->isAliased());
+  CHECK(images->data() == buffer->data());
+  CHECK(subject.findImage(std::vector<std::size_t>{1, 2}) == 5.f);
+
+  SECTION("shared when cloned") {
+    Function clone{Group{VariablesSoup{A, B}}};
+    clone.cloneImages(subject);
+    CHECK(clone.getDenseImages()->data() == buffer->data());
+  }
+
+  SECTION("copied on write") {
+    subject.set(std::vector<std::size_t>{0, 1}, 10.f);
+    CHECK_FALSE(subject.getDenseImages()->isAliased());
+    CHECK(subject.findImage(std::vector<std::size_t>{0, 1}) == 10.f);
+    CHECK(subject.findImage(std::vector<std::size_t>{1, 2}) == 5.f);
+    CHECK(buffer->at(1) == 1.f);
+  }
+}
 } // namespace EFG::test
@@ -4,6 +4,7 @@
 #include <EasyFactorGraph/Error.h>
 #include <EasyFactorGraph/factor/Factor.h>
 #include <EasyFactorGraph/factor/FactorExponential.h>
+#include <EasyFactorGraph/structure/bases/PoolAware.h>
 
 #include "../src/src/io/Utils.h"
 #include "Utils.h"
@@ -135,6 +136,94 @@ TEST_CASE("merge factors", "[factor]") {
   });
 }
 
+TEST_CASE("merge many factors", "[factor]") {
+  auto A = make_variable(3, "A");
+  auto B = make_variable(4, "B");
+  auto C = make_variable(3, "C");
+  auto D = make_variable(2, "D");
+
+  Factor AB(Group{VariablesSoup{A, B}});
+  std::size_t counter = 0;
+  GroupRange AB_range{AB.function().vars()};
+  for_each_combination(AB_range, [&](const auto &comb) {
+    AB.set(comb, static_cast<float>(++counter % 5));
+  });
+  FactorExponential CA(Factor{Group{VariablesSoup{C, A}},
+                              Factor::SimplyCorrelatedTag{}},
+                       0.7f);
+  Factor D_sparse(Group{VariablesSoup{D}});
+  D_sparse.set(std::vector<std::size_t>{1}, 2.f);
+  Factor BDC(Group{VariablesSoup{B, D, C}});
+  setAllImages(BDC, 0.5f);
+
+  std::vector<const Immutable *> factors = {&AB, &CA, &D_sparse, &BDC};
+
+  auto check_merged = [&](const Factor &merged) {
+    REQUIRE(merged.function().vars().getVariablesSet() ==
+            VariablesSet{A, B, C, D});
+    const auto &vars = merged.function().vars().getVariables();
+    bool all_equal = true;
+    merged.function().forEachCombination<false>(
+        [&](const auto &comb, float img) {
+          float expected = 1.f;
+          for (const auto *factor : factors) {
+            expected *= factor->makeFinder(vars).findTransformed(comb);
+          }
+          all_equal = all_equal && almost_equal(img, expected, 0.001f);
+        });
+    CHECK(all_equal);
+  };
+
+  SECTION("single thread") { check_merged(Factor{factors}); }
+
+  SECTION("pool") {
+    auto threads = GENERATE(2, 3);
+    strct::Pool pool{static_cast<std::size_t>(threads)};
+    check_merged(Factor{factors, pool});
+  }
+}
+
+TEST_CASE("merge sparse factors", "[factor]") {
+  auto A = make_variable(3, "A");
+  auto B = make_variable(4, "B");
+  auto C = make_variable(3, "C");
+  auto D = make_variable(6, "D");
+
+  Factor AB_sparse(Group{VariablesSoup{A, B}});
+  AB_sparse.set(std::vector<std::size_t>{0, 1}, 2.f);
+  AB_sparse.set(std::vector<std::size_t>{2, 3}, 0.5f);
+  FactorExponential CA(Factor{Group{VariablesSoup{C, A}},
+                              Factor::SimplyCorrelatedTag{}},
+                       0.7f);
+  Factor BD(Group{VariablesSoup{B, D}});
+  setAllImages(BD, 1.5f);
+  BD.set(std::vector<std::size_t>{1, 2}, 0);
+
+  std::vector<const Immutable *> factors = {&CA, &BD, &AB_sparse};
+  Factor merged(factors);
+  REQUIRE(merged.function().vars().getVariablesSet() ==
+          VariablesSet{A, B, C, D});
+  // the result is as sparse as the sparsest factor
+  CHECK(merged.function().getDenseImages() == nullptr);
+
+  const auto &vars = merged.function().vars().getVariables();
+  bool all_equal = true;
+  std::size_t non_null = 0;
+  merged.function().forEachCombination<false>(
+      [&](const auto &comb, float img) {
+        float expected = 1.f;
+        for (const auto *factor : factors) {
+          expected *= factor->makeFinder(vars).findTransformed(comb);
+        }
+        all_equal = all_equal && almost_equal(img, expected, 0.001f);
+        if (img != 0) {
+          ++non_null;
+        }
+      });
+  CHECK(all_equal);
+  CHECK(non_null == 2 * 3 * 6 - 3);
+}
+
 TEST_CASE("Factor copy c'tor", "[factor]") {
   Group group(VariablesSoup{make_variable(4, "A"), make_variable(4, "B"),
                             make_variable(4, "C")});
@@ -185,4 +274,40 @@ TEST_CASE("Variables order change in factor", "[factor]") {
             std::vector<std::size_t>{0, 1, 1}) == 3.f);
 }
 
+TEST_CASE("Variables order change in dense factor", "[factor]") {
+  VariablesSoup initial_vars = {make_variable(3, "A"), make_variable(20, "B"),
+                                make_variable(2, "C"), make_variable(17, "D")};
+  Factor initial_order(Group{initial_vars});
+  // iterate the group and not the images: setting them may turn the
+  // function into a dense one
+  std::size_t counter = 0;
+  GroupRange range{initial_order.function().vars()};
+  for_each_combination(range, [&](const auto &comb) {
+    initial_order.set(comb, static_cast<float>(++counter));
+  });
+
+  std::vector<std::size_t> permutation = {0, 1, 2, 3};
+  while (std::next_permutation(permutation.begin(), permutation.end())) {
+    VariablesSoup permuted_vars;
+    for (auto p : permutation) {
+      permuted_vars.push_back(initial_vars[p]);
+    }
+    auto different_order =
+        initial_order.cloneWithPermutedGroup(Group{permuted_vars});
+    REQUIRE(different_order.function().vars() == Group{permuted_vars});
+
+    bool all_equal = true;
+    initial_order.function().forEachCombination<false>(
+        [&](const auto &comb, float img) {
+          std::vector<std::size_t> permuted_comb;
+          for (auto p : permutation) {
+            permuted_comb.push_back(comb[p]);
+          }
+          all_equal = all_equal && (different_order.function().findImage(
+                                        permuted_comb) == img);
+        });
+    CHECK(all_equal);
+  }
+}
+
 } // namespace EFG::test
@@ -86,6 +86,28 @@ TEST_CASE("Evidence", "[factor-special]") {
   CHECK(test::almost_equal_fnct(evidence.function(), expected_distr));
 }
 
+TEST_CASE("Evidence slices", "[factor-special]") {
+  auto A = make_variable(3, "A");
+  auto B = make_variable(2, "B");
+  Factor factor(Group{A, B});
+  float img = 0.5f;
+  for (std::size_t a = 0; a < 3; ++a) {
+    for (std::size_t b = 0; b < 2; ++b) {
+      factor.set(std::vector<std::size_t>{a, b}, img);
+      img += 0.5f;
+    }
+  }
+
+  auto evidence_var = GENERATE_COPY(A, B);
+  const auto slices = Evidence::makeSlices(factor, evidence_var);
+  REQUIRE(slices.size() == evidence_var->size());
+  for (std::size_t e = 0; e < slices.size(); ++e) {
+    Evidence expected(factor, evidence_var, e);
+    CHECK(slices[e]->getVariable() == expected.getVariable());
+    CHECK(test::almost_equal_fnct(slices[e]->function(), expected.function()));
+  }
+}
+
 TEST_CASE("Message", "[factor-special]") {
   const float w = 1.3f;
   const float g = 0.6f;
@@ -244,4 +244,82 @@ TEST_CASE("check bad factor insertions are refused", "[insertion]") {
   }
 }
 
+TEST_CASE("bulk factors insertion", "[insertion]") {
+  auto A = make_variable(2, "A");
+  auto B = make_variable(2, "B");
+  auto C = make_variable(2, "C");
+  auto D = make_variable(2, "D");
+  auto E = make_variable(2, "E");
+
+  FactorsTunableManagerTest model;
+
+  auto factor_AB = make_corr_factor_ptr(A, B);
+  auto factor_BC = make_corr_factor_ptr(B, C);
+  auto factor_D = std::make_shared<Factor>(Group{VariablesSoup{D}});
+  model.addConstFactors({factor_AB, factor_BC, factor_D});
+  model.checkPostInsertion();
+  model.checkVariables(VariablesSet{A, B, C, D});
+  CHECK(model.getAllVariables() == VariablesSoup{A, B, C, D});
+  CHECK(model.getConstFactors().size() == 3);
+  CHECK(model.state().clusters.size() == 2);
+
+  SECTION("tunable factors") {
+    auto factor_CD = make_corr_expfactor_ptr(C, D, 1.f);
+    auto factor_DE = make_corr_expfactor_ptr(D, E, 1.f);
+    model.addTunableFactors(
+        {{factor_CD},
+         {factor_DE, factor_CD->function().vars().getVariablesSet()}});
+    model.checkPostInsertion();
+    model.checkVariables(VariablesSet{A, B, C, D, E});
+    CHECK(model.getAllFactors().size() == 5);
+    CHECK(model.getTunableFactors().size() == 2);
+    CHECK(model.getTuners().size() == 1);
+    CHECK(model.state().clusters.size() == 1);
+  }
+
+  SECTION("refused tunable batch with unknown sharing group") {
+    auto factor_CD = make_corr_expfactor_ptr(C, D, 1.f);
+    auto factor_DE = make_corr_expfactor_ptr(D, E, 1.f);
+    // the factor sharing the weight comes after
+    CHECK_THROWS_AS(
+        model.addTunableFactors(
+            {{factor_DE, factor_CD->function().vars().getVariablesSet()},
+             {factor_CD}}),
+        Error);
+    CHECK_THROWS_AS(
+        model.addTunableFactor(factor_DE, VariablesSet{A, E}), Error);
+    model.checkVariables(VariablesSet{A, B, C, D});
+    CHECK(model.getAllFactors().size() == 3);
+    CHECK(model.getTunableFactors().empty());
+    CHECK(model.getTuners().empty());
+  }
+
+  SECTION("refused batches are not inserted") {
+    auto C_bis = make_variable(2, "C");
+    auto factor_DE = make_corr_factor_ptr(D, E);
+
+    SECTION("already connected variables") {
+      CHECK_THROWS_AS(
+          model.addConstFactors({factor_DE, make_corr_factor_ptr(B, A)}),
+          Error);
+    }
+    SECTION("connection repeated in the batch") {
+      CHECK_THROWS_AS(
+          model.addConstFactors({factor_DE, make_corr_factor_ptr(E, D)}),
+          Error);
+    }
+    SECTION("bad variable") {
+      CHECK_THROWS_AS(
+          model.addConstFactors({factor_DE, make_corr_factor_ptr(C_bis, E)}),
+          Error);
+    }
+    SECTION("factor repeated in the batch") {
+      CHECK_THROWS_AS(model.addConstFactors({factor_DE, factor_DE}), Error);
+    }
+
+    model.checkVariables(VariablesSet{A, B, C, D});
+    CHECK(model.getAllFactors().size() == 3);
+    CHECK(model.state().clusters.size() == 2);
+  }
+}
 } // namespace EFG::test
@@ -56,6 +56,8 @@ public:
     }
   };
 
+  const HiddenClusters &clusters() const { return state().clusters; }
+
   void clusterExists(const VariablesSet &vars) {
     auto convert = [](const std::unordered_set<Node *> &nodes) {
       VariablesSet res;
@@ -115,6 +117,50 @@ TEST_CASE("testing evidence managing", "[evidence]") {
   }
 }
 
+TEST_CASE("evidence batch managing", "[evidence]") {
+  EvidenceTest model;
+
+  auto check_clusters = [&model]() {
+    CHECK(model.clusters().size() == 5);
+    model.clusterExists(
+        VariablesSet{model.uVars[0], model.mVars[0], model.lVars[0]});
+    model.clusterExists(VariablesSet{model.uVars[1]});
+    model.clusterExists(VariablesSet{model.uVars[2]});
+    model.clusterExists(VariablesSet{model.lVars[1]});
+    model.clusterExists(VariablesSet{model.lVars[2]});
+  };
+
+  Evidences expected;
+  expected.emplace(model.mVars[1], 0);
+  expected.emplace(model.mVars[2], 1);
+  model.setEvidences(expected);
+  check_clusters();
+  CHECK(model.getEvidences() == expected);
+
+  SECTION("values update") {
+    const auto *clusters_front = &model.clusters().front();
+    std::unordered_map<std::string, std::size_t> ev{{"M1", 1}, {"M2", 0}};
+    model.setEvidences(ev);
+    CHECK(&model.clusters().front() == clusters_front);
+    check_clusters();
+    expected[model.mVars[1]] = 1;
+    expected[model.mVars[2]] = 0;
+    CHECK(model.getEvidences() == expected);
+  }
+
+  SECTION("invalid evidences are refused") {
+    Evidences invalid;
+    invalid.emplace(model.mVars[0], 0);
+    invalid.emplace(model.mVars[1], 2);
+    CHECK_THROWS_AS(model.setEvidences(invalid), Error);
+    std::unordered_map<std::string, std::size_t> inexistent{{"M0", 0},
+                                                            {"X", 0}};
+    CHECK_THROWS_AS(model.setEvidences(inexistent), Error);
+    check_clusters();
+    CHECK(model.getEvidences() == expected);
+  }
+}
+
 TEST_CASE("evidence individual reset", "[evidence]") {
   EvidenceTest model;
 
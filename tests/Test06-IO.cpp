@@ -2,16 +2,23 @@
 #include <catch2/generators/catch_generators.hpp>
 
 #include "Utils.h"
+#include <EasyFactorGraph/categoric/GroupRange.h>
 #include <EasyFactorGraph/model/Graph.h>
 #include <EasyFactorGraph/model/RandomField.h>
 #include <EasyFactorGraph/trainable/tuners/TunerVisitor.h>
 
+#include <EasyFactorGraph/io/TrainSetImport.h>
+#include <EasyFactorGraph/io/bin/Exporter.h>
+#include <EasyFactorGraph/io/bin/Importer.h>
+#include <EasyFactorGraph/io/bin/TrainSetFile.h>
 #include <EasyFactorGraph/io/json/Exporter.h>
 #include <EasyFactorGraph/io/json/Importer.h>
 #include <EasyFactorGraph/io/xml/Exporter.h>
 #include <EasyFactorGraph/io/xml/Importer.h>
 
 #include <algorithm>
+#include <filesystem>
+#include <fstream>
 #include <set>
 
 namespace EFG::test {
@@ -199,6 +206,16 @@ TEST_CASE("json managing", "[io][json]") {
     CHECK(model_imported.checkTunablefactors());
   }
 
+  SECTION("tunable model, many threads") {
+    TestModel model_imported;
+    EFG::io::json::Importer::importFromFile(model_imported, temp_file, 3);
+
+    CHECK(model_imported.checkVariables());
+    CHECK(model_imported.checkEvidences());
+    CHECK(model_imported.checkConstFactors());
+    CHECK(model_imported.checkTunablefactors());
+  }
+
   SECTION("constant model") {
     TestModelBase<Graph> model_imported;
     EFG::io::json::Importer::importFromFile(model_imported, temp_file);
@@ -209,4 +226,258 @@ TEST_CASE("json managing", "[io][json]") {
     CHECK(model_imported.getAllFactors().size() == 8);
   }
 }
+
+TEST_CASE("json streaming import", "[io][json]") {
+  // potentials before variables and variables of the factor before and after
+  // the combinations
+  const std::string source = R"({
+    "Potentials": [
+      {"Distr_val": [{"D": "2.0", "v": ["0", "1"]}, {"D": "3.5", "v": ["1", "2"]}],
+       "Variables": ["A", "B"]},
+      {"Variables": ["B", "C"],
+       "Distr_val": [{"v": ["2", "0"], "D": "1.5"}],
+       "weight": "0.5", "tunability": "Y"},
+      {"Variables": ["A", "C"], "Correlation": "T", "weight": "0.5",
+       "tunability": "Y", "Share": ["B", "C"]}
+    ],
+    "Variables": [
+      {"name": "A", "Size": "3"},
+      {"name": "B", "Size": "3"},
+      {"name": "C", "Size": "3", "evidence": "2"}
+    ]
+  })";
+  const std::string temp_file = "./temp_stream.json";
+  {
+    std::ofstream stream{temp_file};
+    stream << source;
+  }
+
+  RandomField streamed;
+  EFG::io::json::Importer::importFromFile(streamed, temp_file);
+  RandomField parsed;
+  EFG::io::json::Importer::importFromJson(parsed,
+                                          nlohmann::json::parse(source));
+
+  CHECK(streamed.getAllVariables().size() == 3);
+  CHECK(streamed.getEvidences().size() == 1);
+  CHECK(streamed.getEvidences().at(streamed.findVariable("C")) == 2);
+  CHECK(streamed.getConstFactors().size() == 1);
+  CHECK(streamed.getTunableFactors().size() == 2);
+  CHECK(streamed.getWeights() == parsed.getWeights());
+  CHECK(almost_equal_fnct(streamed.getConstFactors().begin()->get()->function(),
+                          parsed.getConstFactors().begin()->get()->function()));
+  CHECK(almost_equal_it(streamed.getMarginalDistribution("A"),
+                        parsed.getMarginalDistribution("A"), 0.001f));
+  CHECK(almost_equal_it(streamed.getMarginalDistribution("B"),
+                        parsed.getMarginalDistribution("B"), 0.001f));
+
+  RandomField parsed_parallel;
+  EFG::io::json::Importer::importFromJson(
+      parsed_parallel, nlohmann::json::parse(source), 2);
+  CHECK(parsed_parallel.getWeights() == parsed.getWeights());
+  CHECK(almost_equal_it(parsed_parallel.getMarginalDistribution("A"),
+                        parsed.getMarginalDistribution("A"), 0.001f));
+
+  RandomField streamed_parallel;
+  EFG::io::json::Importer::importFromFile(streamed_parallel, temp_file, 3);
+  CHECK(streamed_parallel.getWeights() == parsed.getWeights());
+  CHECK(almost_equal_fnct(
+      streamed_parallel.getConstFactors().begin()->get()->function(),
+      parsed.getConstFactors().begin()->get()->function()));
+  CHECK(almost_equal_it(streamed_parallel.getMarginalDistribution("A"),
+                        parsed.getMarginalDistribution("A"), 0.001f));
+}
+
+TEST_CASE("json streaming import, many threads", "[io][json]") {
+  // variables before potentials: a single thread builds the factors while
+  // parsing, many threads build them after
+  const std::size_t size = 4;
+  RandomField model;
+  auto prev = make_variable(size, "V0");
+  for (std::size_t k = 1; k < 12; ++k) {
+    auto next = make_variable(size, "V" + std::to_string(k));
+    auto factor = std::make_shared<Factor>(Group{prev, next});
+    GroupRange range{factor->function().vars()};
+    std::vector<std::vector<std::size_t>> combinations;
+    for_each_combination(range, [&](const auto &comb) {
+      combinations.push_back(comb);
+    });
+    for (std::size_t c = 0; c < combinations.size(); c += (k % 3) + 1) {
+      factor->set(combinations[c], 0.1f * static_cast<float>(c + k));
+    }
+    if (k % 2 == 0) {
+      model.copyConstFactor(*factor);
+    } else {
+      model.addTunableFactor(
+          std::make_shared<FactorExponential>(
+              *factor, 0.2f * static_cast<float>(k)));
+    }
+    prev = next;
+  }
+  model.setEvidence(model.findVariable("V3"), 1);
+  const std::string temp_file = "./temp_stream_threads.json";
+  EFG::io::json::Exporter::exportToFile(model, temp_file);
+
+  RandomField streamed;
+  EFG::io::json::Importer::importFromFile(streamed, temp_file);
+  RandomField streamed_parallel;
+  EFG::io::json::Importer::importFromFile(streamed_parallel, temp_file, 4);
+
+  CHECK(streamed_parallel.getAllVariables().size() ==
+        streamed.getAllVariables().size());
+  CHECK(streamed_parallel.getEvidences().size() == 1);
+  CHECK(streamed_parallel.getConstFactors().size() ==
+        streamed.getConstFactors().size());
+  CHECK(streamed_parallel.getTunableFactors().size() ==
+        streamed.getTunableFactors().size());
+  CHECK(streamed_parallel.getWeights() == streamed.getWeights());
+  for (const auto &var : streamed.getAllVariables()) {
+    CHECK(almost_equal_it(
+        streamed_parallel.getMarginalDistribution(var->name()),
+        streamed.getMarginalDistribution(var->name()), 0.001f));
+    CHECK(almost_equal_it(streamed.getMarginalDistribution(var->name()),
+                          model.getMarginalDistribution(var->name()),
+                          0.001f));
+  }
+}
+
+TEST_CASE("binary managing", "[io][bin]") {
+  TestModel model{TestModel::FillTag{}};
+  const std::string temp_file = "./temp.efgb";
+
+  EFG::io::bin::Exporter::exportToFile(model, temp_file);
+
+  SECTION("tunable model") {
+    TestModel model_imported;
+    EFG::io::bin::Importer::importFromFile(model_imported, temp_file);
+
+    CHECK(model_imported.checkVariables());
+    CHECK(model_imported.checkEvidences());
+    CHECK(model_imported.checkConstFactors());
+    CHECK(model_imported.checkTunablefactors());
+
+    for (const auto &name : {"V0", "V1", "V2", "V3"}) {
+      CHECK(almost_equal_it(
+          model_imported.getMarginalDistribution(name),
+          model.getMarginalDistribution(name), 0.001f));
+    }
+  }
+
+  SECTION("constant model") {
+    TestModelBase<Graph> model_imported;
+    EFG::io::bin::Importer::importFromFile(model_imported, temp_file);
+
+    CHECK(model_imported.checkVariables());
+    CHECK(model_imported.checkEvidences());
+    CHECK(model_imported.getConstFactors().size() == 8);
+    CHECK(model_imported.getAllFactors().size() == 8);
+  }
+}
+
+TEST_CASE("train set import", "[io]") {
+  const std::string temp_file = "./temp_train_set.txt";
+  {
+    std::ofstream stream{temp_file};
+    stream << "0 1 2\n2 1 0\n\n0 1 300\n";
+  }
+  auto train_set = EFG::io::import_train_set(temp_file);
+  CHECK(train_set.size() == 3);
+  const std::vector<std::vector<std::size_t>> expected = {
+      {0, 1, 2}, {2, 1, 0}, {0, 1, 300}};
+  CHECK(static_cast<std::vector<std::vector<std::size_t>>>(
+            train_set.getCombinations()) == expected);
+
+  {
+    std::ofstream stream{temp_file};
+    stream << "0 1 2\n2 1\n";
+  }
+  CHECK_THROWS_AS(EFG::io::import_train_set(temp_file), Error);
+}
+
+TEST_CASE("binary train set", "[io][bin]") {
+  const VariablesSoup variables = {make_variable(2, "A"), make_variable(3, "B"),
+                                   make_variable(300, "C")};
+  const std::vector<std::vector<std::size_t>> expected = {
+      {0, 1, 2}, {1, 2, 0}, {0, 1, 299}};
+  const std::string temp_file = "./temp_train_set.efgt";
+
+  auto check_imported = [&]() {
+    auto [imported_vars, train_set] = EFG::io::bin::import_train_set(temp_file);
+    REQUIRE(imported_vars.size() == variables.size());
+    for (std::size_t k = 0; k < variables.size(); ++k) {
+      CHECK(*imported_vars[k] == *variables[k]);
+    }
+    CHECK(train_set.getCombinations().isAliased());
+    CHECK(static_cast<std::vector<std::vector<std::size_t>>>(
+              train_set.getCombinations()) == expected);
+  };
+
+  SECTION("export and import") {
+    EFG::io::bin::export_train_set(temp_file, variables,
+                                   CombinationMatrix{expected});
+    check_imported();
+  }
+
+  SECTION("read by chunks") {
+    EFG::io::bin::export_train_set(temp_file, variables,
+                                   CombinationMatrix{expected});
+    EFG::io::bin::TrainSetFileSource source{temp_file, 2};
+    CHECK(source.getVariables().size() == variables.size());
+    for (std::size_t k = 0; k < 2; ++k) {
+      std::vector<std::vector<std::size_t>> got;
+      std::vector<std::size_t> chunks_sizes;
+      while (auto chunk = source.nextChunk()) {
+        chunks_sizes.push_back(chunk->size());
+        for (const auto row : chunk.value()) {
+          got.emplace_back(row);
+        }
+      }
+      CHECK(chunks_sizes == std::vector<std::size_t>{2, 1});
+      CHECK(got == expected);
+      source.rewind();
+    }
+  }
+
+  SECTION("conversion from text") {
+    const std::string text_file = "./temp_train_set.txt";
+    {
+      std::ofstream stream{text_file};
+      stream << "0 1 2\n1 2 0\n0 1 299\n";
+    }
+    EFG::io::bin::convert_train_set(text_file, variables, temp_file);
+    check_imported();
+  }
+
+  SECTION("invalid values") {
+    CHECK_THROWS_AS(EFG::io::bin::export_train_set(
+                        temp_file, variables,
+                        CombinationMatrix{
+                            std::vector<std::vector<std::size_t>>{{0, 3, 0}}}),
+                    Error);
+    CHECK_THROWS_AS(EFG::io::bin::export_train_set(
+                        temp_file, VariablesSoup{variables.front()},
+                        CombinationMatrix{expected}),
+                    Error);
+  }
+
+  SECTION("binary model is not a train set") {
+    EFG::io::bin::Exporter::exportToFile(TestModel{TestModel::FillTag{}},
+                                         temp_file);
+    CHECK_THROWS_AS(EFG::io::bin::import_train_set(temp_file), Error);
+  }
+
+  SECTION("full device") {
+    // every write to this device fails as the disk was full
+    const std::string full_file = "/dev/full";
+    if (std::filesystem::exists(full_file)) {
+      CHECK_THROWS_AS(
+          EFG::io::bin::export_train_set(full_file, variables,
+                                         CombinationMatrix{expected}),
+          Error);
+      CHECK_THROWS_AS(EFG::io::bin::Exporter::exportToFile(
+                          TestModel{TestModel::FillTag{}}, full_file),
+                      Error);
+    }
+  }
+}
 } // namespace EFG::test
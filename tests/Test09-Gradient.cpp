@@ -3,10 +3,19 @@
 
 #include "Utils.h"
 #include <EasyFactorGraph/categoric/GroupRange.h>
+#include <EasyFactorGraph/model/ConditionalRandomField.h>
 #include <EasyFactorGraph/model/RandomField.h>
+#include <EasyFactorGraph/structure/BaselineLoopyPropagator.h>
 #include <EasyFactorGraph/structure/GibbsSampler.h>
+#include <EasyFactorGraph/trainable/TrainSetSource.h>
 #include <EasyFactorGraph/trainable/tuners/BaseTuner.h>
 
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <set>
+#include <thread>
+
 namespace EFG::test {
 using namespace categoric;
 using namespace train;
@@ -56,6 +65,292 @@ public:
 };
 } // namespace
 
+TEST_CASE("Train set empirical distributions", "[gradient]") {
+  const Combinations combinations = {{0, 2, 1}, {1, 0, 1}, {0, 2, 1},
+                                     {1, 1, 0}, {0, 2, 0}, {1, 0, 1}};
+  auto compact = GENERATE(false, true);
+  const TrainSet train_set(combinations, compact);
+
+  const auto iterator = train_set.makeIterator();
+  const auto &distribution =
+      iterator.getEmpiricalDistribution({1}, std::vector<std::size_t>{3});
+  CHECK(almost_equal_it(distribution,
+                        std::vector<float>{2.f / 6.f, 1.f / 6.f, 3.f / 6.f},
+                        0.001f));
+  CHECK(almost_equal_it(
+      iterator.getEmpiricalDistribution({2, 0}, {2, 2}),
+      std::vector<float>{1.f / 6.f, 1.f / 6.f, 2.f / 6.f, 2.f / 6.f},
+      0.001f));
+
+  // shared by the iterators of the entire train set
+  const auto other_iterator = train_set.makeIterator();
+  CHECK(&other_iterator.getEmpiricalDistribution({1}, {3}) == &distribution);
+
+  const auto sub_set = train_set.makeSubSetIterator(0.5f);
+  float total = 0;
+  for (float frequency : sub_set.getEmpiricalDistribution({1}, {3})) {
+    total += frequency;
+  }
+  CHECK(almost_equal(total, 1.f, 0.001f));
+
+  CHECK_THROWS_AS(iterator.getEmpiricalDistribution({1}, {2}), Error);
+
+  // requested by many threads at the same time
+  std::vector<const std::vector<float> *> computed(4, nullptr);
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < computed.size(); ++t) {
+    threads.emplace_back([&, t]() {
+      computed[t] = &iterator.getEmpiricalDistribution({0, 1}, {2, 3});
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (const auto *distribution : computed) {
+    CHECK(distribution == computed.front());
+  }
+  CHECK(almost_equal_it(*computed.front(),
+                        std::vector<float>{0, 0, 3.f / 6.f, 2.f / 6.f,
+                                           1.f / 6.f, 0},
+                        0.001f));
+}
+
+TEST_CASE("Minibatch scheduler", "[gradient]") {
+  const Combinations combinations = {{0, 2, 1}, {1, 0, 1}, {0, 2, 1},
+                                     {1, 1, 0}, {0, 2, 0}, {1, 0, 1},
+                                     {0, 0, 0}};
+  auto compact = GENERATE(false, true);
+  const TrainSet train_set(combinations, compact);
+  using Sample = std::vector<std::size_t>;
+
+  MinibatchScheduler scheduler(train_set, 0.3f, 5);
+  CHECK(scheduler.getBatchSize() == 2);
+  CHECK(scheduler.getEpoch() == 0);
+
+  auto sorted = [](std::vector<Sample> subject) {
+    std::sort(subject.begin(), subject.end());
+    return subject;
+  };
+  const auto expected = sorted(combinations);
+  std::vector<std::vector<Sample>> epochs;
+  for (std::size_t epoch = 1; epoch <= 3; ++epoch) {
+    // every sample is visited exactly once per epoch
+    auto &visited = epochs.emplace_back();
+    while (visited.size() < combinations.size()) {
+      const auto batch = scheduler.next();
+      CHECK(scheduler.getEpoch() == epoch);
+      CHECK(batch.size() <= scheduler.getBatchSize());
+      batch.forEachSample([&](const auto &combination, std::size_t count) {
+        visited.insert(visited.end(), count, combination);
+      });
+    }
+    CHECK(sorted(visited) == expected);
+  }
+  CHECK(epochs.front() != epochs.back());
+
+  // same seed, same batches
+  MinibatchScheduler other(train_set, 0.3f, 5);
+  for (const auto &epoch : epochs) {
+    std::vector<Sample> visited;
+    while (visited.size() < combinations.size()) {
+      other.next().forEachSample(
+          [&](const auto &combination, std::size_t count) {
+            visited.insert(visited.end(), count, combination);
+          });
+    }
+    CHECK(visited == epoch);
+  }
+
+  CHECK_THROWS_AS(MinibatchScheduler(train_set, 0), Error);
+  CHECK_THROWS_AS(MinibatchScheduler(train_set, 1.5f), Error);
+}
+
+TEST_CASE("Minibatches of a compacted train set", "[gradient]") {
+  // the repeated samples are never expanded
+  const std::size_t repetitions = 1000000000;
+  const TrainSet train_set(CombinationMatrix{Combinations{{0, 1}, {1, 0}}},
+                           std::vector<std::size_t>{repetitions, 1});
+  MinibatchScheduler scheduler(train_set, 1e-8f, 0);
+  std::size_t first_combination = 0;
+  for (std::size_t b = 0; b < 10; ++b) {
+    const auto batch = scheduler.next();
+    CHECK(batch.size() == scheduler.getBatchSize());
+    batch.forEachSample([&](const auto &combination, std::size_t count) {
+      if (combination[0] == 0) {
+        first_combination += count;
+      }
+    });
+  }
+  CHECK(scheduler.getEpoch() == 1);
+  // the second combination is drawn with a negligible probability
+  CHECK(first_combination >= 10 * scheduler.getBatchSize() - 1);
+
+  const auto subset = train_set.makeSubSetIterator(1e-8f);
+  CHECK(subset.size() == scheduler.getBatchSize());
+}
+
+TEST_CASE("Train subset sampled without replacement", "[gradient]") {
+  Combinations combinations;
+  for (std::size_t k = 0; k < 50; ++k) {
+    combinations.push_back({k / 10, k % 10});
+  }
+  const TrainSet train_set(combinations);
+  using Sample = std::vector<std::size_t>;
+  const auto subset = train_set.makeSubSetIterator(0.5f);
+  CHECK(subset.size() == 25);
+  std::set<Sample> visited;
+  subset.forEachSample([&](const auto &combination, std::size_t) {
+    CHECK(visited.emplace(combination).second);
+  });
+}
+
+TEST_CASE("Weights stored in a contiguous buffer", "[gradient]") {
+  auto A = make_variable(2, "A");
+  auto B = make_variable(2, "B");
+  auto C = make_variable(2, "C");
+  auto D = make_variable(2, "D");
+  auto make_model = [&](const std::vector<float> &weights) {
+    RandomField model;
+    model.addTunableFactor(make_corr_expfactor_ptr(A, B, weights[0]));
+    model.addTunableFactor(make_corr_expfactor_ptr(B, C, weights[1]));
+    model.addTunableFactor(make_corr_expfactor_ptr(C, D, weights[0]),
+                           VariablesSet{A, B});
+    model.setEvidence(C, 1);
+    return model;
+  };
+  RandomField model = make_model({1.f, 0.5f});
+  const auto marginal_A = model.getMarginalDistribution(A);
+
+  auto span = model.getWeightsSpan();
+  REQUIRE(span.has_value());
+  CHECK(almost_equal_it(*span, std::vector<float>{1.f, 0.5f}, 0.001f));
+
+  // only the caches depending on the changed weights are rebuilt
+  const std::vector<float> new_weights = {2.f, 1.5f};
+  SECTION("set weights") { model.setWeights(new_weights); }
+  SECTION("update weights in place") {
+    CHECK(model.updateWeights([&](Span<float> weights) {
+      std::copy(new_weights.begin(), new_weights.end(), weights.begin());
+    }));
+  }
+  CHECK(almost_equal_it(model.getWeights(), new_weights, 0.001f));
+  for (const auto &factor : model.getTunableFactors()) {
+    const auto &vars = factor->function().vars().getVariablesSet();
+    const float expected =
+        (vars == VariablesSet{B, C}) ? new_weights[1] : new_weights[0];
+    CHECK(almost_equal(factor->getWeight(), expected, 0.001f));
+  }
+  RandomField expected = make_model(new_weights);
+  CHECK_FALSE(almost_equal_it(model.getMarginalDistribution(A), marginal_A,
+                              0.001f));
+  CHECK(almost_equal_it(model.getMarginalDistribution(A),
+                        expected.getMarginalDistribution(A), 0.001f));
+
+  // shallow copies share the buffer
+  RandomField shallow_copy(model);
+  CHECK(shallow_copy.getWeightsSpan()->data() ==
+        model.getWeightsSpan()->data());
+  shallow_copy.setWeights({1.f, 0.5f});
+  CHECK(almost_equal_it(model.getWeights(), std::vector<float>{1.f, 0.5f},
+                        0.001f));
+  // the caches of the model are refreshed as well
+  CHECK(almost_equal_it(model.getMarginalDistribution(A), marginal_A,
+                        0.001f));
+  CHECK(almost_equal_it(shallow_copy.getMarginalDistribution(A), marginal_A,
+                        0.001f));
+
+  // a factor bound to a weight of model can't share the weight of a cluster
+  // of another model
+  FactorExponentialPtr factor_BC;
+  for (const auto &factor : model.getTunableFactors()) {
+    if (factor->function().vars().getVariablesSet() == VariablesSet{B, C}) {
+      factor_BC = factor;
+    }
+  }
+  auto E = make_variable(2, "E");
+  RandomField other;
+  other.addTunableFactor(make_corr_expfactor_ptr(D, E, 2.f));
+  CHECK_THROWS_AS(other.addTunableFactor(factor_BC, VariablesSet{D, E}),
+                  Error);
+  CHECK(other.getAllFactors().size() == 1);
+  CHECK(almost_equal(factor_BC->getWeight(), 0.5f, 0.001f));
+  // still driven by model
+  model.setWeights({1.f, 3.f});
+  CHECK(almost_equal(factor_BC->getWeight(), 3.f, 0.001f));
+}
+
+TEST_CASE("Pseudo-likelihood gradient", "[gradient]") {
+  auto A = make_variable(2, "A");
+  auto B = make_variable(2, "B");
+  auto C = make_variable(2, "C");
+  auto D = make_variable(2, "D");
+  // loopy model
+  RandomField model;
+  model.addConstFactor(make_corr_expfactor_ptr(A, C, 1.5f));
+  model.addTunableFactor(make_corr_expfactor_ptr(A, B, 1.f));
+  model.addTunableFactor(make_corr_expfactor_ptr(B, C, 0.5f));
+  model.addTunableFactor(make_corr_expfactor_ptr(C, D, 1.f),
+                         VariablesSet{A, B});
+  const auto train_set = make_good_trainset(model, 200);
+  const auto samples = train_set.makeIterator();
+
+  const bool with_evidence = GENERATE(false, true);
+  if (with_evidence) {
+    model.setEvidence(D, 0);
+  }
+  // log of the pseudo-likelihood, divided by the number of samples
+  auto pseudo_likelihood = [&]() {
+    LikelihoodGetter activations(model);
+    const auto &vars = model.getAllVariables();
+    float result = 0;
+    samples.forEachSample([&](const auto &sample, std::size_t count) {
+      std::vector<std::size_t> comb;
+      for (std::size_t k = 0; k < sample.size(); ++k) {
+        comb.push_back(sample[k]);
+      }
+      for (std::size_t p = 0; p < vars.size(); ++p) {
+        if (with_evidence && (vars[p] == D)) {
+          continue;
+        }
+        const float observed = activations.getLogActivation(comb);
+        const std::size_t observed_value = comb[p];
+        float normalization = 0;
+        for (std::size_t v = 0; v < vars[p]->size(); ++v) {
+          comb[p] = v;
+          normalization += expf(activations.getLogActivation(comb));
+        }
+        comb[p] = observed_value;
+        result += count * (observed - logf(normalization));
+      }
+    });
+    return result / samples.size();
+  };
+
+  model.setWeights({0.5f, 2.f});
+  const std::size_t threads = GENERATE(1, 2);
+  const auto gradient = model.getPseudoLikelihoodGradient(samples, threads);
+  REQUIRE(gradient.size() == 2);
+  const float delta = 0.01f;
+  for (std::size_t k = 0; k < gradient.size(); ++k) {
+    auto weights = model.getWeights();
+    weights[k] += delta;
+    model.setWeights(weights);
+    const float forward = pseudo_likelihood();
+    weights[k] -= 2.f * delta;
+    model.setWeights(weights);
+    const float backward = pseudo_likelihood();
+    weights[k] += delta;
+    model.setWeights(weights);
+    CHECK(almost_equal(gradient[k], (forward - backward) / (2.f * delta),
+                       0.02f));
+  }
+
+  GeneratedSource source(
+      [&](std::size_t) { return train_set.getCombinations(); }, 2);
+  CHECK(almost_equal_it(model.getPseudoLikelihoodGradient(source, threads),
+                        gradient, 0.001f));
+}
+
 TEST_CASE("Gradient evaluation on binary factor", "[gradient]") {
   TunableModelTest model;
 
@@ -102,4 +397,264 @@ TEST_CASE("Gradient evaluation on chain models", "[gradient]") {
   }
 }
 
+TEST_CASE("Conditional gradient with many threads", "[gradient]") {
+  auto A = make_variable(2, "A");
+  auto B = make_variable(2, "B");
+  auto C = make_variable(2, "C");
+  auto D = make_variable(2, "D");
+  RandomField source;
+  source.addTunableFactor(make_corr_expfactor_ptr(A, B, 1.f));
+  source.addTunableFactor(make_corr_expfactor_ptr(B, C, 0.5f));
+  source.addTunableFactor(make_corr_expfactor_ptr(C, D, 2.f));
+  source.setEvidence(A, 0);
+  ConditionalRandomField model(source, false);
+
+  const auto train_set = make_good_trainset(model, 500);
+  const auto samples = train_set.makeIterator();
+  const std::size_t threads = GENERATE(2, 3);
+
+  auto check_same_gradient = [&]() {
+    const auto expected = model.getWeightsGradient(samples, 1);
+    const auto got = model.getWeightsGradient(samples, threads);
+    REQUIRE(got.size() == expected.size());
+    for (std::size_t k = 0; k < got.size(); ++k) {
+      CHECK(almost_equal(got[k], expected[k], 0.001f));
+    }
+  };
+
+  check_same_gradient();
+
+  SECTION("weights changed after the first computation") {
+    model.setWeights(std::vector<float>{2.f, 1.f, 0.5f});
+    check_same_gradient();
+  }
+}
+
+namespace {
+struct PropagationsLog {
+  std::atomic<std::size_t> calls = 0;
+  // calls that received a context different than the expected one
+  std::atomic<std::size_t> wrong_context_calls = 0;
+  std::atomic<std::size_t> expected_iterations = 0;
+};
+
+class LoggingPropagator : public LoopyBeliefPropagationStrategy {
+public:
+  LoggingPropagator(std::shared_ptr<PropagationsLog> log)
+      : log{std::move(log)} {}
+
+  bool propagateBelief(HiddenCluster &subject, PropagationKind kind,
+                       const PropagationContext &context, Pool &pool) final {
+    ++log->calls;
+    if (context.max_iterations_loopy_propagation !=
+        log->expected_iterations) {
+      ++log->wrong_context_calls;
+    }
+    return baseline.propagateBelief(subject, kind, context, pool);
+  }
+
+private:
+  std::shared_ptr<PropagationsLog> log;
+  BaselineLoopyPropagator baseline;
+};
+} // namespace
+
+TEST_CASE("Conditional loopy gradient with many threads", "[gradient]") {
+  auto A = make_variable(2, "A");
+  auto B = make_variable(2, "B");
+  auto C = make_variable(2, "C");
+  auto D = make_variable(2, "D");
+  auto E = make_variable(2, "E");
+  RandomField source;
+  source.addTunableFactor(make_corr_expfactor_ptr(A, B, 1.f));
+  source.addTunableFactor(make_corr_expfactor_ptr(B, C, 2.f));
+  source.addTunableFactor(make_corr_expfactor_ptr(C, D, 1.5f));
+  source.addTunableFactor(make_corr_expfactor_ptr(D, E, 2.f));
+  source.addTunableFactor(make_corr_expfactor_ptr(E, B, 1.5f));
+  source.setEvidence(A, 0);
+  ConditionalRandomField model(source, false);
+
+  const auto train_set = make_good_trainset(model, 500);
+  const auto samples = train_set.makeIterator();
+  const std::size_t threads = GENERATE(2, 3);
+
+  auto log = std::make_shared<PropagationsLog>();
+  auto set_context = [&](std::size_t iterations) {
+    log->expected_iterations = iterations;
+    model.setPropagationContext(PropagationContext{iterations});
+  };
+  set_context(200);
+  model.setLoopyPropagationStrategy(std::make_unique<LoggingPropagator>(log));
+
+  auto check_same_gradient = [&]() {
+    log->calls = 0;
+    const auto expected = model.getWeightsGradient(samples, 1);
+    const std::size_t single_thread_calls = log->calls;
+    CHECK(0 < single_thread_calls);
+    const auto got = model.getWeightsGradient(samples, threads);
+    // the replicas used the strategy and the context of the model
+    CHECK(log->calls == 2 * single_thread_calls);
+    CHECK(log->wrong_context_calls == 0);
+    REQUIRE(got.size() == expected.size());
+    for (std::size_t k = 0; k < got.size(); ++k) {
+      CHECK(almost_equal(got[k], expected[k], 0.001f));
+    }
+  };
+
+  check_same_gradient();
+
+  SECTION("context changed after the first computation") {
+    set_context(150);
+    check_same_gradient();
+  }
+}
+
+TEST_CASE("Gradient on compacted train set", "[gradient]") {
+  auto A = make_variable(2, "A");
+  auto B = make_variable(2, "B");
+  auto C = make_variable(2, "C");
+  RandomField model;
+  model.addTunableFactor(make_corr_expfactor_ptr(A, B, 1.f));
+  model.addTunableFactor(make_corr_expfactor_ptr(B, C, 0.5f));
+
+  const auto samples = make_good_trainset(model, 500).getCombinations();
+  const TrainSet train_set(samples);
+  const TrainSet compacted(samples, true);
+  CHECK(compacted.size() == samples.size());
+  CHECK(compacted.getCombinations().size() <= 8);
+  {
+    std::size_t total = 0;
+    for (auto count : compacted.getCounts()) {
+      total += count;
+    }
+    CHECK(total == samples.size());
+  }
+
+  auto check_same_gradient = [](FactorsTunableGetter &subject,
+                                const TrainSet &expected_set,
+                                const TrainSet &got_set) {
+    const auto expected_it = expected_set.makeIterator();
+    const auto expected = subject.getWeightsGradient(expected_it);
+    const auto got_it = got_set.makeIterator();
+    const auto got = subject.getWeightsGradient(got_it);
+    REQUIRE(got.size() == expected.size());
+    for (std::size_t k = 0; k < got.size(); ++k) {
+      CHECK(almost_equal(got[k], expected[k], 0.001f));
+    }
+  };
+
+  SECTION("random field") { check_same_gradient(model, train_set, compacted); }
+
+  SECTION("conditional random field") {
+    model.setEvidence(A, 1);
+    ConditionalRandomField conditioned(model, false);
+    check_same_gradient(conditioned, train_set, compacted);
+
+    // the gradient is the weighted average of the ones of every combination.
+    // Iterators are all kept alive, as tuners recognize them by address
+    std::vector<float> expected(2, 0);
+    const auto &combinations = compacted.getCombinations();
+    std::list<TrainSet::Iterator> singles;
+    for (std::size_t k = 0; k < combinations.size(); ++k) {
+      const auto &single_it = singles.emplace_back(
+          TrainSet{Combinations{combinations[k]}}.makeIterator());
+      const auto single_grad = conditioned.getWeightsGradient(single_it);
+      const float weight = static_cast<float>(compacted.getCounts()[k]) /
+                           static_cast<float>(compacted.size());
+      for (std::size_t w = 0; w < expected.size(); ++w) {
+        expected[w] += weight * single_grad[w];
+      }
+    }
+    const auto compacted_it = compacted.makeIterator();
+    const auto got = conditioned.getWeightsGradient(compacted_it);
+    CHECK(almost_equal_it(got, expected, 0.001f));
+  }
+
+  SECTION("invalid counts") {
+    CHECK_THROWS_AS(TrainSet(compacted.getCombinations(),
+                             std::vector<std::size_t>{1}),
+                    Error);
+  }
+}
+
+TEST_CASE("Gradient from train set source", "[gradient]") {
+  auto A = make_variable(2, "A");
+  auto B = make_variable(2, "B");
+  auto C = make_variable(2, "C");
+  RandomField model;
+  model.addTunableFactor(make_corr_expfactor_ptr(A, B, 1.f));
+  model.addTunableFactor(make_corr_expfactor_ptr(B, C, 0.5f));
+
+  const auto samples = make_good_trainset(model, 500).getCombinations();
+  const TrainSet train_set(samples);
+
+  // the last chunk is smaller than the others
+  const std::size_t chunk_size = 120;
+  auto make_chunk = [&samples, chunk_size](std::size_t index) {
+    CombinationMatrix result{samples.columns()};
+    const std::size_t end = std::min(samples.size(), (index + 1) * chunk_size);
+    for (std::size_t r = index * chunk_size; r < end; ++r) {
+      result.push_back(samples[r]);
+    }
+    return result;
+  };
+  const std::size_t chunks = (samples.size() + chunk_size - 1) / chunk_size;
+
+  auto read_ahead = GENERATE(false, true);
+  std::unique_ptr<TrainSetSource> source =
+      std::make_unique<GeneratedSource>(make_chunk, chunks);
+  if (read_ahead) {
+    source = std::make_unique<ReadAheadSource>(std::move(source));
+  }
+
+  auto check_same_gradient = [&](FactorsTunableGetter &subject) {
+    const auto train_set_it = train_set.makeIterator();
+    const auto expected = subject.getWeightsGradient(train_set_it);
+    // the source is rewound after every computation
+    for (std::size_t k = 0; k < 2; ++k) {
+      const auto got = subject.getWeightsGradient(*source);
+      CHECK(almost_equal_it(got, expected, 0.001f));
+    }
+  };
+
+  SECTION("random field") { check_same_gradient(model); }
+
+  SECTION("conditional random field") {
+    model.setEvidence(A, 1);
+    ConditionalRandomField conditioned(model, false);
+    check_same_gradient(conditioned);
+  }
+
+  SECTION("empty source") {
+    GeneratedSource empty{make_chunk, 0};
+    CHECK_THROWS_AS(model.getWeightsGradient(empty), Error);
+  }
+
+  SECTION("failing chunk") {
+    // read by the background thread of the read ahead source
+    std::atomic<bool> fail = true;
+    std::unique_ptr<TrainSetSource> failing = std::make_unique<GeneratedSource>(
+        [&](std::size_t index) {
+          if (fail && (index == 2)) {
+            throw Error{"chunk not available"};
+          }
+          return make_chunk(index);
+        },
+        chunks);
+    if (read_ahead) {
+      failing = std::make_unique<ReadAheadSource>(std::move(failing));
+    }
+    auto use_pseudo_likelihood = GENERATE(false, true);
+    auto gradient_of = [&](TrainSetSource &subject) {
+      return use_pseudo_likelihood ? model.getPseudoLikelihoodGradient(subject)
+                                   : model.getWeightsGradient(subject);
+    };
+    CHECK_THROWS_AS(gradient_of(*failing), Error);
+    // the source was rewound: the next pass starts from the first chunk
+    fail = false;
+    GeneratedSource reference{make_chunk, chunks};
+    CHECK(almost_equal_it(gradient_of(*failing), gradient_of(reference),
+                          0.001f));
+  }
+}
 } // namespace EFG::test
@@ -1,3 +1,5 @@
+#ifdef EFG_LEARNING_ENABLED
+
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
 
@@ -472,3 +474,5 @@ TEST_CASE("Train with Pool efficiency", "[train][!mayfail]") {
 */
 
 } // namespace EFG::test
+
+#endif
@@ -0,0 +1,182 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "Utils.h"
+#include <EasyFactorGraph/model/RandomField.h>
+#include <EasyFactorGraph/structure/SpecialFactors.h>
+#include <EasyFactorGraph/trainable/ModelTrainer.h>
+#include <EasyFactorGraph/trainable/Optimizers.h>
+
+#include <functional>
+#include <math.h>
+#include <memory>
+
+namespace EFG::test {
+using namespace categoric;
+using namespace model;
+using namespace train;
+
+namespace {
+using OptimizerFactory = std::function<std::unique_ptr<Optimizer>()>;
+
+template <typename OptimizerT, typename... Args>
+OptimizerFactory make_factory(Args... args) {
+  return [args...]() { return std::make_unique<OptimizerT>(args...); };
+}
+
+Span<float> make_span(std::vector<float> &subject) {
+  return Span<float>{subject.data(), subject.size()};
+}
+
+Span<const float> make_span(const std::vector<float> &subject) {
+  return Span<const float>{subject.data(), subject.size()};
+}
+
+// remembers the weights buffers passed to every step
+class RecordingSGD : public SGD {
+public:
+  RecordingSGD() : SGD(0.5f, 0.5f) {}
+
+  void step(Span<float> weights, Span<const float> gradient) override {
+    buffers.push_back(weights.data());
+    SGD::step(weights, gradient);
+  }
+
+  std::vector<const float *> buffers;
+};
+} // namespace
+
+TEST_CASE("Optimizers on concave quadratic", "[optimizers]") {
+  // f(w) = - 0.5 * sum_k curvatures[k] * (w[k] - optimum[k])^2
+  const std::vector<float> curvatures = {1.f, 4.f, 0.5f};
+  const std::vector<float> optimum = {1.f, -2.f, 3.f};
+  auto gradient_at = [&](const std::vector<float> &w) {
+    std::vector<float> result;
+    for (std::size_t k = 0; k < w.size(); ++k) {
+      result.push_back(-curvatures[k] * (w[k] - optimum[k]));
+    }
+    return result;
+  };
+
+  auto factory =
+      GENERATE(make_factory<SGD>(0.2f), make_factory<SGD>(0.2f, 0.5f),
+               make_factory<Adam>(0.05f), make_factory<LBFGS>());
+  auto optimizer = factory();
+  std::vector<float> w = {0, 0, 0};
+  optimizer->reset(w.size());
+  for (std::size_t iter = 0; iter < 1000; ++iter) {
+    optimizer->step(make_span(w), make_span(gradient_at(w)));
+  }
+  CHECK(almost_equal_it(w, optimum, 0.05f));
+
+  std::vector<float> wrong_size = {0, 0};
+  CHECK_THROWS_AS(
+      optimizer->step(make_span(wrong_size), make_span(gradient_at(w))),
+      Error);
+}
+
+TEST_CASE("Optimizers invalid parameters", "[optimizers]") {
+  CHECK_THROWS_AS(SGD(0), Error);
+  CHECK_THROWS_AS(SGD(0.1f, 1.f), Error);
+  CHECK_THROWS_AS(Adam(0.1f, 1.f), Error);
+  CHECK_THROWS_AS(Adam(0.1f, 0.9f, 0.999f, 0), Error);
+  CHECK_THROWS_AS(LBFGS(0), Error);
+  CHECK_THROWS_AS(LBFGS(5, -1.f), Error);
+
+  SGD optimizer(0.1f);
+  CHECK_THROWS_AS(optimizer.setMaxIterations(0), Error);
+  CHECK_THROWS_AS(optimizer.setTolerance(-1.f), Error);
+}
+
+TEST_CASE("Random field tuning with native optimizers", "[optimizers]") {
+  auto make_model = []() {
+    VariablePtr A = make_variable(3, "A");
+    VariablePtr B = make_variable(3, "B");
+    VariablePtr C = make_variable(3, "C");
+    RandomField model;
+    model.copyConstFactor(
+        factor::FactorExponential{factor::Indicator{A, 0}, 1.f});
+    model.addTunableFactor(make_corr_expfactor_ptr(A, B, 2.f));
+    model.addTunableFactor(make_corr_expfactor_ptr(A, C, 0.5f));
+    return model;
+  };
+  RandomField reference = make_model();
+  const auto samples = make_good_trainset(reference, 500);
+
+  RandomField to_train = make_model();
+  set_ones(to_train);
+
+  auto factory = GENERATE(make_factory<SGD>(0.5f, 0.5f),
+                          make_factory<Adam>(0.2f), make_factory<LBFGS>());
+  auto optimizer = factory();
+  optimizer->setMaxIterations(100);
+  train_model(to_train, *optimizer, samples);
+  CHECK(almost_equal_it(reference.getWeights(), to_train.getWeights(), 0.5f));
+
+  SECTION("stochastic") {
+    set_ones(to_train);
+    Adam stochastic_optimizer(0.1f);
+    stochastic_optimizer.setMaxIterations(200);
+    TrainInfo info;
+    info.stochastic_percentage = 0.3f;
+    info.seed = 0;
+    train_model(to_train, stochastic_optimizer, samples, info);
+    CHECK(
+        almost_equal_it(reference.getWeights(), to_train.getWeights(), 0.5f));
+  }
+
+  SECTION("pseudo-likelihood") {
+    set_ones(to_train);
+    Adam pl_optimizer(0.2f);
+    pl_optimizer.setMaxIterations(100);
+    TrainInfo info;
+    info.objective = TrainObjective::PSEUDO_LIKELIHOOD;
+    train_model(to_train, pl_optimizer, samples, info);
+    CHECK(
+        almost_equal_it(reference.getWeights(), to_train.getWeights(), 0.5f));
+  }
+
+  SECTION("weights updated in place") {
+    set_ones(to_train);
+    RecordingSGD recording_optimizer;
+    recording_optimizer.setMaxIterations(100);
+    train_model(to_train, recording_optimizer, samples);
+    CHECK(
+        almost_equal_it(reference.getWeights(), to_train.getWeights(), 0.5f));
+    REQUIRE(!recording_optimizer.buffers.empty());
+    const auto *buffer = to_train.getWeightsSpan()->data();
+    for (const auto *used : recording_optimizer.buffers) {
+      CHECK(used == buffer);
+    }
+  }
+
+  SECTION("scattered weights") {
+    // a tunable factor bound to the weights of another model
+    RandomField donor = make_model();
+    auto find_factor = [&donor](const std::string &other) {
+      const VariablesSet vars{donor.findVariable("A"),
+                              donor.findVariable(other)};
+      for (const auto &factor : donor.getTunableFactors()) {
+        if (factor->function().vars().getVariablesSet() == vars) {
+          return factor;
+        }
+      }
+      throw Error{"factor not found"};
+    };
+    RandomField scattered;
+    scattered.addTunableFactor(find_factor("B"));
+    scattered.addTunableFactor(
+        std::make_shared<factor::FactorExponential>(*find_factor("C")));
+    scattered.copyConstFactor(factor::FactorExponential{
+        factor::Indicator{donor.findVariable("A"), 0}, 1.f});
+    set_ones(scattered);
+    REQUIRE(!scattered.getWeightsSpan().has_value());
+
+    RecordingSGD recording_optimizer;
+    recording_optimizer.setMaxIterations(100);
+    train_model(scattered, recording_optimizer, samples);
+    CHECK(almost_equal_it(reference.getWeights(), scattered.getWeights(),
+                          0.5f));
+  }
+}
+} // namespace EFG::test
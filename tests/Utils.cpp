@@ -136,9 +136,11 @@ float LikelihoodGetter::getLogLikeliHood(
     });
   }
   float lkl = 0.f, coeff = 1.f / static_cast<float>(combinations.size());
-  combinations.forEachSample([this, &lkl, &coeff](const auto &comb) {
-    lkl += coeff * this->getLogActivation(comb);
-  });
+  combinations.forEachSample(
+      [this, &lkl, &coeff](const auto &comb, std::size_t weight) {
+        lkl +=
+            coeff * static_cast<float>(weight) * this->getLogActivation(comb);
+      });
   return lkl - Z;
 }
 